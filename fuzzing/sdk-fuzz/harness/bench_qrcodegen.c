@@ -0,0 +1,146 @@
+/* Host benchmark of the QR Code encoder (not a fuzzer).
+ *
+ * Times qrcodegen_encodeText() on typical payloads, from an address to a full version 10 QR Code
+ * (as used for PSBT or UR fragments), and the Reed-Solomon ECC computation alone.
+ * Built only with -DSDK_FUZZ_BENCHMARKS=ON, without sanitizers nor fuzzing instrumentation.
+ *
+ * Usage: bench_qrcodegen [nb_iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "os_task.h"
+#include "qrcodegen.h"
+
+#define DEFAULT_NB_ITERATIONS 2000
+
+// exposed by qrcodegen.c when built with QRCODEGEN_TEST
+void addEccAndInterleave(uint8_t data[], int version, enum qrcodegen_Ecc ecl, uint8_t result[]);
+int  getNumDataCodewords(int version, enum qrcodegen_Ecc ecl);
+
+typedef struct {
+    const char        *name;
+    size_t             length;
+    char               charset;  // 'N' for numeric, 'A' for alphanumeric, 'B' for bytes
+    enum qrcodegen_Ecc ecl;
+} bench_case_t;
+
+static const bench_case_t bench_cases[] = {
+    {"address (42 B, ECC low)",            42,  'B', qrcodegen_Ecc_LOW    },
+    {"address (42 B, ECC high)",           42,  'B', qrcodegen_Ecc_HIGH   },
+    {"UR fragment (200 B, ECC low)",       200, 'A', qrcodegen_Ecc_LOW    },
+    {"PSBT chunk (200 B, ECC medium)",     200, 'B', qrcodegen_Ecc_MEDIUM },
+    {"max bytes (271 B, v10, ECC low)",    271, 'B', qrcodegen_Ecc_LOW    },
+    {"max numeric (652 digits, v10, low)", 652, 'N', qrcodegen_Ecc_LOW    },
+};
+
+void __attribute__((noreturn)) os_sched_exit(bolos_task_status_t exit_code)
+{
+    fprintf(stderr, "qrcodegen assertion failed (%d)\n", (int) exit_code);
+    exit(1);
+}
+
+static double now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void fill_text(char *text, size_t length, char charset)
+{
+    static const char alphanumeric[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ $%*+-./:";
+
+    for (size_t i = 0; i < length; i++) {
+        switch (charset) {
+            case 'N':
+                text[i] = '0' + (rand() % 10);
+                break;
+            case 'A':
+                text[i] = alphanumeric[rand() % (sizeof(alphanumeric) - 1)];
+                break;
+            default:
+                text[i] = 'a' + (rand() % 26);
+                break;
+        }
+    }
+    text[length] = '\0';
+}
+
+static void bench_encode(const bench_case_t *bench, int nb_iterations)
+{
+    uint8_t tempBuffer[qrcodegen_BUFFER_LEN_MAX];
+    uint8_t qrcode[qrcodegen_BUFFER_LEN_MAX];
+    char    text[1024];
+    int     version = 0;
+    double  start;
+
+    fill_text(text, bench->length, bench->charset);
+    start = now_us();
+    for (int i = 0; i < nb_iterations; i++) {
+        // change one character so that no result can be reused
+        text[i % bench->length] = text[(i + 1) % bench->length];
+        if (!qrcodegen_encodeText(text,
+                                  tempBuffer,
+                                  qrcode,
+                                  bench->ecl,
+                                  qrcodegen_VERSION_MIN,
+                                  qrcodegen_VERSION_MAX,
+                                  qrcodegen_Mask_AUTO,
+                                  false)) {
+            printf("%-38s: too long\n", bench->name);
+            return;
+        }
+        version = (qrcodegen_getSize(qrcode) - 17) / 4;
+    }
+    printf("%-38s: v%-2d %8.1f us/encode\n",
+           bench->name,
+           version,
+           (now_us() - start) / nb_iterations);
+}
+
+static void bench_ecc(enum qrcodegen_Ecc ecl, int nb_iterations)
+{
+    static const char *ecl_names[] = {"low", "medium", "quartile", "high"};
+    uint8_t            data[qrcodegen_BUFFER_LEN_MAX];
+    uint8_t            result[qrcodegen_BUFFER_LEN_MAX];
+    int                version = qrcodegen_VERSION_MAX;
+    int                dataLen = getNumDataCodewords(version, ecl);
+    char               name[64];
+    double             start;
+
+    start = now_us();
+    for (int i = 0; i < nb_iterations; i++) {
+        for (int j = 0; j < dataLen; j++) {
+            data[j] = (uint8_t) (i + j);
+        }
+        addEccAndInterleave(data, version, ecl, result);
+    }
+    snprintf(name, sizeof(name), "Reed-Solomon only (v%d, ECC %s)", version, ecl_names[ecl]);
+    printf("%-38s: v%-2d %8.1f us/encode\n", name, version, (now_us() - start) / nb_iterations);
+}
+
+int main(int argc, char *argv[])
+{
+    int nb_iterations = DEFAULT_NB_ITERATIONS;
+
+    if (argc > 1) {
+        nb_iterations = atoi(argv[1]);
+        if (nb_iterations <= 0) {
+            fprintf(stderr, "usage: %s [nb_iterations]\n", argv[0]);
+            return 1;
+        }
+    }
+    srand(0);
+    for (size_t i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); i++) {
+        bench_encode(&bench_cases[i], nb_iterations);
+    }
+    for (int ecl = qrcodegen_Ecc_LOW; ecl <= qrcodegen_Ecc_HIGH; ecl++) {
+        bench_ecc((enum qrcodegen_Ecc) ecl, nb_iterations * 10);
+    }
+    return 0;
+}
@@ -84,6 +84,57 @@
 #define DEFAULT_APDU_INS_STACK_CONSUMPTION 0x57
 #endif  // DEBUG_OS_STACK_CONSUMPTION
 
+#if defined(HAVE_IO_PROFILING)
+/**
+ * @brief Instruction code with CLA = 0xB0 to get the IO counters and latency
+ *        histograms of the running application.
+ * @details P2 selects the counters: 0 for the global ones (time spent waiting for
+ * events and sending responses, with the resolution of the ticker), 1 + transport
+ * index for the ones of a transport (exchanged APDUs and bytes, transmission errors).
+ * With P1=1, every counter is reset once read.
+ *
+ * - Command APDU
+ * |FIELD |LENGTH |VALUE |DESCRIPTION       |
+ * |------|-------|------|------------------|
+ * |CLA   |0x01   |0xB0  |Instruction class |
+ * |INS   |0x01   |0x58  |Instruction code  |
+ * |P1    |0x01   |MODE  |0 = READ, 1 = READ AND RESET |
+ * |P2    |0x01   |SELECTOR |0 = GLOBAL, 1..7 = TRANSPORT |
+ * |LC    |0x01   |0x00  |No data           |
+ *
+ * - Response APDU
+ * |DATA        |LENGTH | DESCRIPTION                    |
+ * |------------|-------|--------------------------------|
+ * |COUNTERS    |var    | Format version then U4BE counters (see os_io_profiling_get) |
+ * |STATUS_WORD |0x02   | 0x9000 on success              |
+ */
+#define DEFAULT_APDU_INS_IO_PROFILING 0x58
+#endif  // HAVE_IO_PROFILING
+
+#if defined(HAVE_MEMORY_PROFILING_RING)
+/**
+ * @brief Instruction code with CLA = 0xB0 to read the ring buffer of the memory
+ *        profiling events of the running application.
+ * @details The dump is read by chunks of up to 250 bytes, with increasing offsets,
+ * until a shorter response. It is decoded by tools/memprof.py.
+ *
+ * - Command APDU
+ * |FIELD |LENGTH |VALUE |DESCRIPTION       |
+ * |------|-------|------|------------------|
+ * |CLA   |0x01   |0xB0  |Instruction class |
+ * |INS   |0x01   |0x59  |Instruction code  |
+ * |P1-P2 |0x02   |OFFSET |Offset in the dump (U2BE) |
+ * |LC    |0x01   |0x00  |No data           |
+ *
+ * - Response APDU
+ * |DATA        |LENGTH | DESCRIPTION                    |
+ * |------------|-------|--------------------------------|
+ * |DUMP        |var    | Part of the dump (see mem_profiling.c) |
+ * |STATUS_WORD |0x02   | 0x9000 on success              |
+ */
+#define DEFAULT_APDU_INS_MEM_PROFILING 0x59
+#endif  // HAVE_MEMORY_PROFILING_RING
+
 /**
  * @brief Instruction code with CLA = 0xB0 to exit
  *        the running application.
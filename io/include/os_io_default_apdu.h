@@ -35,6 +35,8 @@ typedef enum {
 #define DEFAULT_APDU_INS_LOAD_CERTIFICATE  (0x06)
 #define DEFAULT_APDU_INS_ADDRESS_BOOK      (0x10)
 #define DEFAULT_APDU_INS_STACK_CONSUMPTION (0x57)
+#define DEFAULT_APDU_INS_IO_PROFILING      (0x58)
+#define DEFAULT_APDU_INS_MEM_PROFILING     (0x59)
 #define DEFAULT_APDU_INS_APP_EXIT          (0xA7)
 
 #define DEFAULT_APDU_INS_STR(x)                                      \
@@ -43,6 +45,8 @@ typedef enum {
      : x == DEFAULT_APDU_INS_LOAD_CERTIFICATE  ? "LOAD_CERTIFICATE"  \
      : x == DEFAULT_APDU_INS_ADDRESS_BOOK      ? "ADDRESS_BOOK"      \
      : x == DEFAULT_APDU_INS_STACK_CONSUMPTION ? "STACK_CONSUMPTION" \
+     : x == DEFAULT_APDU_INS_IO_PROFILING      ? "IO_PROFILING"      \
+     : x == DEFAULT_APDU_INS_MEM_PROFILING     ? "MEM_PROFILING"     \
      : x == DEFAULT_APDU_INS_APP_EXIT          ? "APP_EXIT"          \
                                                : "UNKNOWN")
 
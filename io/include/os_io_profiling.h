@@ -0,0 +1,108 @@
+/*****************************************************************************
+ *   (c) 2025 Ledger SAS.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#ifdef HAVE_IO_PROFILING
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+
+/* Exported enumerations -----------------------------------------------------*/
+typedef enum {
+    OS_IO_PROFILING_TRANSPORT_RAW,
+    OS_IO_PROFILING_TRANSPORT_USB_HID,
+    OS_IO_PROFILING_TRANSPORT_USB_WEBUSB,
+    OS_IO_PROFILING_TRANSPORT_USB_CCID,
+    OS_IO_PROFILING_TRANSPORT_USB_U2F,
+    OS_IO_PROFILING_TRANSPORT_BLE,
+    OS_IO_PROFILING_TRANSPORT_NFC,
+    OS_IO_PROFILING_TRANSPORT_NB,
+} os_io_profiling_transport_t;
+
+/* Exported defines   --------------------------------------------------------*/
+// Bucket 0 counts durations below 1ms, bucket i durations in [2^(i-1), 2^i[ ms, and the last
+// bucket every longer duration
+#define OS_IO_PROFILING_HISTOGRAM_SIZE (10)
+
+// Period of the SEPH ticker, used by the default time source.
+// No finer clock is available to applications on this layer: the durations have the resolution
+// of the ticker, so that they tell long waits in the IO layer apart, but can't measure the
+// processing time of an APDU (most commands are processed within a single ticker period).
+#ifndef OS_IO_PROFILING_TICKER_MS
+#define OS_IO_PROFILING_TICKER_MS (100)
+#endif  // OS_IO_PROFILING_TICKER_MS
+
+// os_io_profiling_get() selectors
+#define OS_IO_PROFILING_GLOBAL (0)
+// 1 + os_io_profiling_transport_t selects the counters of a transport
+
+/* Exported types, structures, unions ----------------------------------------*/
+typedef struct {
+    uint32_t count;
+    uint32_t total_ms;
+    uint32_t max_ms;
+    uint32_t buckets[OS_IO_PROFILING_HISTOGRAM_SIZE];
+} os_io_profiling_histogram_t;
+
+typedef struct {
+    uint32_t rx_apdus;
+    uint32_t rx_bytes;
+    uint32_t tx_apdus;
+    uint32_t tx_bytes;
+    uint32_t tx_errors;
+} os_io_profiling_transport_counters_t;
+
+typedef struct {
+    uint32_t now_ms;  // clock of the default time source
+    uint32_t rx_events;
+
+    // Time spent waiting for an event in os_io_rx_evt
+    os_io_profiling_histogram_t rx_wait;
+    // Time spent in os_io_tx_cmd (including the busy loops waiting for the transport)
+    os_io_profiling_histogram_t tx;
+
+    os_io_profiling_transport_counters_t transports[OS_IO_PROFILING_TRANSPORT_NB];
+} os_io_profiling_t;
+
+/* Exported macros------------------------------------------------------------*/
+
+/* Exported variables --------------------------------------------------------*/
+
+/* Exported functions prototypes--------------------------------------------- */
+/**
+ * @brief Time source of the measurements, in milliseconds
+ * @note The default implementation only advances on SEPH ticker events, hence has the
+ *       resolution of the ticker. Being weak, it can be overridden by a finer clock.
+ */
+uint32_t os_io_profiling_get_time_ms(void);
+
+void os_io_profiling_reset(void);
+void os_io_profiling_rx(const uint8_t *buffer, int status, uint32_t start_ms);
+void os_io_profiling_tx(uint8_t type, uint16_t length, int status, uint32_t start_ms);
+
+/**
+ * @brief Serializes (U4BE) a set of counters
+ *
+ * @param selector OS_IO_PROFILING_GLOBAL, or 1 + os_io_profiling_transport_t
+ * @param buffer_out output buffer
+ * @param buffer_out_length in: size of buffer_out, out: length of the serialized counters
+ * @return 0 on success, -1 on bad selector or too small buffer
+ */
+int os_io_profiling_get(uint8_t selector, uint8_t *buffer_out, size_t *buffer_out_length);
+
+#endif  // HAVE_IO_PROFILING
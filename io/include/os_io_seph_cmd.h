@@ -45,10 +45,14 @@ typedef enum {
 /* Exported types, structures, unions ----------------------------------------*/
 
 /* Exported defines   --------------------------------------------------------*/
+// Interval between two ticker events, as set up by the OS when an app is started
+#define OS_IO_SEPH_DEFAULT_TICKER_INTERVAL_MS (100)
 
 /* Exported macros------------------------------------------------------------*/
 
 /* Exported variables --------------------------------------------------------*/
+// Interval between two ticker events, as last set up with os_io_seph_cmd_setup_ticker()
+extern unsigned int G_io_ticker_interval_ms;
 
 /* Exported functions prototypes--------------------------------------------- */
 
@@ -38,6 +38,13 @@
 #if defined(HAVE_ADDRESS_BOOK)
 #include "address_book.h"
 #endif
+#if defined(HAVE_IO_PROFILING)
+#include "os_io_profiling.h"
+#endif  // HAVE_IO_PROFILING
+#if defined(HAVE_MEMORY_PROFILING_RING)
+#include "os_math.h"
+#include "mem_profiling.h"
+#endif  // HAVE_MEMORY_PROFILING_RING
 
 /* Private enumerations ------------------------------------------------------*/
 
@@ -193,6 +200,36 @@ static bolos_err_t get_stack_consumption(uint8_t  mode,
 }
 #endif  // DEBUG_OS_STACK_CONSUMPTION
 
+#if defined(HAVE_IO_PROFILING)
+static bolos_err_t get_io_profiling(uint8_t  mode,
+                                    uint8_t  selector,
+                                    uint8_t *buffer_out,
+                                    size_t  *buffer_out_length)
+{
+    if (os_io_profiling_get(selector, buffer_out, buffer_out_length) < 0) {
+        *buffer_out_length = 0;
+        return SWO_WRONG_P1_P2;
+    }
+    if (mode == 1) {
+        os_io_profiling_reset();
+    }
+    return SWO_SUCCESS;
+}
+#endif  // HAVE_IO_PROFILING
+
+#if defined(HAVE_MEMORY_PROFILING_RING)
+static bolos_err_t get_mem_profiling(uint16_t offset,
+                                     uint8_t *buffer_out,
+                                     size_t  *buffer_out_length)
+{
+    // room is kept for the status word, a response shorter than the max one ends the dump
+    size_t max_length = MIN(*buffer_out_length - 2, MEM_PROFILING_DUMP_CHUNK_SIZE);
+
+    *buffer_out_length = mem_profiling_dump(offset, buffer_out, max_length);
+    return SWO_SUCCESS;
+}
+#endif  // HAVE_MEMORY_PROFILING_RING
+
 #if defined(HAVE_LEDGER_PKI)
 static bolos_err_t pki_load_certificate(uint8_t *buffer, size_t buffer_len, uint8_t key_usage)
 {
@@ -290,6 +327,33 @@ bolos_err_t os_io_handle_default_apdu(uint8_t                  *buffer_in,
                 break;
 #endif  // DEBUG_OS_STACK_CONSUMPTION
 
+#if defined(HAVE_IO_PROFILING)
+            case DEFAULT_APDU_INS_IO_PROFILING:
+                if (buffer_in[APDU_OFF_P1] > 1) {
+                    err = SWO_WRONG_P1_P2;
+                    goto end;
+                }
+                // Same case-1 APDU handling as STACK_CONSUMPTION above
+                if (buffer_in_length <= APDU_OFF_LC || buffer_in[APDU_OFF_LC] == 0) {
+                    err = get_io_profiling(buffer_in[APDU_OFF_P1],
+                                           buffer_in[APDU_OFF_P2],
+                                           buffer_out,
+                                           buffer_out_length);
+                }
+                else {
+                    err = SWO_INCORRECT_P3_LENGTH;
+                    goto end;
+                }
+                break;
+#endif  // HAVE_IO_PROFILING
+
+#if defined(HAVE_MEMORY_PROFILING_RING)
+            case DEFAULT_APDU_INS_MEM_PROFILING:
+                err = get_mem_profiling(
+                    U2BE(buffer_in, APDU_OFF_P1), buffer_out, buffer_out_length);
+                break;
+#endif  // HAVE_MEMORY_PROFILING_RING
+
             case DEFAULT_APDU_INS_APP_EXIT:
                 if (buffer_in[APDU_OFF_P1] == 0 && buffer_in[APDU_OFF_P2] == 0) {
                     *buffer_out_length = 0;
@@ -0,0 +1,204 @@
+/*****************************************************************************
+ *   (c) 2025 Ledger SAS.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#ifdef HAVE_IO_PROFILING
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "os_io.h"
+#include "os_utils.h"
+#include "os_io_profiling.h"
+#include "seproxyhal_protocol.h"
+
+/* Private enumerations ------------------------------------------------------*/
+
+/* Private types, structures, unions -----------------------------------------*/
+
+/* Private defines------------------------------------------------------------*/
+#define OS_IO_PROFILING_FORMAT (2)
+
+// U4BE count, total and max, then bucket count and U4BE buckets
+#define HISTOGRAM_SERIALIZED_SIZE (3 * 4 + 1 + OS_IO_PROFILING_HISTOGRAM_SIZE * 4)
+
+/* Private macros-------------------------------------------------------------*/
+
+/* Private functions prototypes ----------------------------------------------*/
+
+/* Exported variables --------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+static os_io_profiling_t os_io_profiling;
+
+/* Private functions ---------------------------------------------------------*/
+static int get_transport(uint8_t type)
+{
+    switch (type) {
+        case OS_IO_PACKET_TYPE_RAW_APDU:
+            return OS_IO_PROFILING_TRANSPORT_RAW;
+        case OS_IO_PACKET_TYPE_USB_HID_APDU:
+            return OS_IO_PROFILING_TRANSPORT_USB_HID;
+        case OS_IO_PACKET_TYPE_USB_WEBUSB_APDU:
+            return OS_IO_PROFILING_TRANSPORT_USB_WEBUSB;
+        case OS_IO_PACKET_TYPE_USB_CCID_APDU:
+            return OS_IO_PROFILING_TRANSPORT_USB_CCID;
+        case OS_IO_PACKET_TYPE_USB_U2F_HID_APDU:
+        case OS_IO_PACKET_TYPE_USB_U2F_HID_CBOR:
+        case OS_IO_PACKET_TYPE_USB_U2F_HID_CANCEL:
+        case OS_IO_PACKET_TYPE_USB_U2F_HID_RAW:
+            return OS_IO_PROFILING_TRANSPORT_USB_U2F;
+        case OS_IO_PACKET_TYPE_BLE_APDU:
+        case OS_IO_PACKET_TYPE_BLE_U2F_APDU:
+            return OS_IO_PROFILING_TRANSPORT_BLE;
+        case OS_IO_PACKET_TYPE_NFC_APDU:
+            return OS_IO_PROFILING_TRANSPORT_NFC;
+        default:
+            return -1;
+    }
+}
+
+static void histogram_add(os_io_profiling_histogram_t *histogram, uint32_t duration_ms)
+{
+    uint8_t bucket = 0;
+
+    while ((bucket < OS_IO_PROFILING_HISTOGRAM_SIZE - 1) && (duration_ms >> bucket)) {
+        bucket++;
+    }
+    histogram->buckets[bucket]++;
+    histogram->count++;
+    histogram->total_ms += duration_ms;
+    if (duration_ms > histogram->max_ms) {
+        histogram->max_ms = duration_ms;
+    }
+}
+
+static size_t histogram_serialize(const os_io_profiling_histogram_t *histogram, uint8_t *buffer)
+{
+    size_t offset = 0;
+
+    U4BE_ENCODE(buffer, offset, histogram->count);
+    offset += 4;
+    U4BE_ENCODE(buffer, offset, histogram->total_ms);
+    offset += 4;
+    U4BE_ENCODE(buffer, offset, histogram->max_ms);
+    offset += 4;
+    buffer[offset++] = OS_IO_PROFILING_HISTOGRAM_SIZE;
+    for (uint8_t bucket = 0; bucket < OS_IO_PROFILING_HISTOGRAM_SIZE; bucket++) {
+        U4BE_ENCODE(buffer, offset, histogram->buckets[bucket]);
+        offset += 4;
+    }
+
+    return offset;
+}
+
+/* Exported functions --------------------------------------------------------*/
+__attribute__((weak)) uint32_t os_io_profiling_get_time_ms(void)
+{
+    return os_io_profiling.now_ms;
+}
+
+void os_io_profiling_reset(void)
+{
+    uint32_t now_ms = os_io_profiling.now_ms;
+
+    memset(&os_io_profiling, 0, sizeof(os_io_profiling));
+    os_io_profiling.now_ms = now_ms;
+}
+
+void os_io_profiling_rx(const uint8_t *buffer, int status, uint32_t start_ms)
+{
+    if (status <= 0) {
+        return;
+    }
+
+    if (((buffer[0] == OS_IO_PACKET_TYPE_SEPH) || (buffer[0] == OS_IO_PACKET_TYPE_SE_EVT))
+        && (status > 1) && (buffer[1] == SEPROXYHAL_TAG_TICKER_EVENT)) {
+        os_io_profiling.now_ms += OS_IO_PROFILING_TICKER_MS;
+    }
+
+    uint32_t now_ms = os_io_profiling_get_time_ms();
+    os_io_profiling.rx_events++;
+    histogram_add(&os_io_profiling.rx_wait, now_ms - start_ms);
+
+    int transport = get_transport(buffer[0]);
+    if (transport >= 0) {
+        os_io_profiling.transports[transport].rx_apdus++;
+        os_io_profiling.transports[transport].rx_bytes += status - 1;
+    }
+}
+
+void os_io_profiling_tx(uint8_t type, uint16_t length, int status, uint32_t start_ms)
+{
+    int transport = get_transport(type);
+    if (transport < 0) {
+        return;
+    }
+
+    os_io_profiling_transport_counters_t *counters = &os_io_profiling.transports[transport];
+
+    histogram_add(&os_io_profiling.tx, os_io_profiling_get_time_ms() - start_ms);
+    if (status < 0) {
+        counters->tx_errors++;
+    }
+    else {
+        counters->tx_apdus++;
+        counters->tx_bytes += length;
+    }
+}
+
+int os_io_profiling_get(uint8_t selector, uint8_t *buffer_out, size_t *buffer_out_length)
+{
+    size_t offset = 0;
+
+    if (selector == OS_IO_PROFILING_GLOBAL) {
+        if (*buffer_out_length < 1 + 2 * 4 + 2 * HISTOGRAM_SERIALIZED_SIZE) {
+            return -1;
+        }
+        buffer_out[offset++] = OS_IO_PROFILING_FORMAT;
+        U4BE_ENCODE(buffer_out, offset, os_io_profiling_get_time_ms());
+        offset += 4;
+        U4BE_ENCODE(buffer_out, offset, os_io_profiling.rx_events);
+        offset += 4;
+        offset += histogram_serialize(&os_io_profiling.rx_wait, &buffer_out[offset]);
+        offset += histogram_serialize(&os_io_profiling.tx, &buffer_out[offset]);
+    }
+    else if (selector <= OS_IO_PROFILING_TRANSPORT_NB) {
+        const os_io_profiling_transport_counters_t *counters
+            = &os_io_profiling.transports[selector - 1];
+
+        if (*buffer_out_length < 1 + 5 * 4) {
+            return -1;
+        }
+        buffer_out[offset++] = OS_IO_PROFILING_FORMAT;
+        U4BE_ENCODE(buffer_out, offset, counters->rx_apdus);
+        offset += 4;
+        U4BE_ENCODE(buffer_out, offset, counters->rx_bytes);
+        offset += 4;
+        U4BE_ENCODE(buffer_out, offset, counters->tx_apdus);
+        offset += 4;
+        U4BE_ENCODE(buffer_out, offset, counters->tx_bytes);
+        offset += 4;
+        U4BE_ENCODE(buffer_out, offset, counters->tx_errors);
+        offset += 4;
+    }
+    else {
+        return -1;
+    }
+
+    *buffer_out_length = offset;
+    return 0;
+}
+
+#endif  // HAVE_IO_PROFILING
@@ -38,6 +38,7 @@
 /* Private functions prototypes ----------------------------------------------*/
 
 /* Exported variables --------------------------------------------------------*/
+unsigned int G_io_ticker_interval_ms = OS_IO_SEPH_DEFAULT_TICKER_INTERVAL_MS;
 
 /* Private variables ---------------------------------------------------------*/
 static const unsigned char seph_io_general_status[] = {
@@ -125,7 +126,11 @@ int os_io_seph_cmd_setup_ticker(unsigned int interval_ms)
     buffer[2] = 2;
     buffer[3] = (interval_ms >> 8) & 0xff;
     buffer[4] = (interval_ms) &0xff;
-    return os_io_tx_cmd(OS_IO_PACKET_TYPE_SEPH, buffer, 5, NULL);
+    int status = os_io_tx_cmd(OS_IO_PACKET_TYPE_SEPH, buffer, 5, NULL);
+    if (status >= 0) {
+        G_io_ticker_interval_ms = interval_ms;
+    }
+    return status;
 }
 
 int os_io_seph_cmd_device_shutdown(uint8_t critical_battery)
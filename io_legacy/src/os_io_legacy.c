@@ -35,12 +35,26 @@
 
 #ifdef HAVE_IO_U2F
 #include "u2f_service.h"
+#include "u2f_transport.h"
 #endif  // HAVE_IO_U2F
 
+// The pending U2F channels are handled by the USB stack receiving the HID packets: with
+// USE_OS_IO_STACK, this is the OS one, and there is nothing to dispatch on the app side
+#if defined(HAVE_IO_USB) && defined(HAVE_IO_U2F) && (U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0) \
+    && !defined(USE_OS_IO_STACK)
+#include "os_io_seph_cmd.h"
+#include "usbd_ledger_hid_u2f.h"
+#define IO_LEGACY_U2F_PENDING_CHANNELS
+#endif  // HAVE_IO_USB && HAVE_IO_U2F && U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0 && !USE_OS_IO_STACK
+
 #ifdef HAVE_NFC_READER
 #include "nfc_ledger.h"
 #endif  // HAVE_NFC_READER
 
+#ifdef HAVE_IO_PROFILING
+#include "os_io_profiling.h"
+#endif  // HAVE_IO_PROFILING
+
 /* Private enumerations ------------------------------------------------------*/
 
 /* Private types, structures, unions -----------------------------------------*/
@@ -58,6 +72,8 @@ static void io_nfc_event(uint8_t *buffer_in, size_t buffer_in_length);
 static void io_nfc_ticker(void);
 static void io_nfc_process_events(void);
 #endif
+static int io_legacy_tx_cmd(uint8_t type, const unsigned char *buffer, unsigned short length);
+static int io_legacy_rx_evt(void);
 
 /* Exported variables --------------------------------------------------------*/
 io_seph_app_t G_io_app;
@@ -82,6 +98,53 @@ static apdu_type_t io_os_legacy_apdu_type;
 static uint8_t     need_to_start_io;
 
 /* Private functions ---------------------------------------------------------*/
+static int io_legacy_tx_cmd(uint8_t type, const unsigned char *buffer, unsigned short length)
+{
+#ifdef HAVE_IO_PROFILING
+    uint32_t start_ms = os_io_profiling_get_time_ms();
+    int      status   = os_io_tx_cmd(type, buffer, length, 0);
+    os_io_profiling_tx(type, length, status, start_ms);
+    return status;
+#else   // !HAVE_IO_PROFILING
+    return os_io_tx_cmd(type, buffer, length, 0);
+#endif  // !HAVE_IO_PROFILING
+}
+
+// Receives the next event or packet in G_io_rx_buffer, and returns its length
+static int io_legacy_rx_evt(void)
+{
+    int status = 0;
+
+#ifdef IO_LEGACY_U2F_PENDING_CHANNELS
+    // A request buffered on another U2F channel may be ready since the last response has been
+    // sent: dispatch it without waiting for a new event
+    status = USBD_LEDGER_data_ready(G_io_rx_buffer, sizeof(G_io_rx_buffer));
+    if (status > 0) {
+        return status;
+    }
+#endif  // IO_LEGACY_U2F_PENDING_CHANNELS
+
+#ifdef HAVE_IO_PROFILING
+    uint32_t start_ms = os_io_profiling_get_time_ms();
+    status            = os_io_rx_evt(G_io_rx_buffer, sizeof(G_io_rx_buffer), NULL, true);
+    os_io_profiling_rx(G_io_rx_buffer, status, start_ms);
+#else   // !HAVE_IO_PROFILING
+    status = os_io_rx_evt(G_io_rx_buffer, sizeof(G_io_rx_buffer), NULL, true);
+#endif  // !HAVE_IO_PROFILING
+
+#ifdef IO_LEGACY_U2F_PENDING_CHANNELS
+    if ((status > 1)
+        && ((G_io_rx_buffer[0] == OS_IO_PACKET_TYPE_SEPH)
+            || (G_io_rx_buffer[0] == OS_IO_PACKET_TYPE_SE_EVT))
+        && (G_io_rx_buffer[1] == SEPROXYHAL_TAG_TICKER_EVENT)) {
+        // Lets the buffered U2F requests time out if their client is gone
+        USBD_LEDGER_HID_U2F_ticker(G_io_ticker_interval_ms);
+    }
+#endif  // IO_LEGACY_U2F_PENDING_CHANNELS
+
+    return status;
+}
+
 static io_apdu_media_t get_media_from_apdu_type(apdu_type_t apdu_type)
 {
     if (apdu_type == APDU_TYPE_RAW) {
@@ -129,7 +192,7 @@ void io_seproxyhal_io_heartbeat(void)
 {
     uint16_t      err = SWO_COMMAND_NOT_ACCEPTED;
     unsigned char err_buffer[2];
-    int           status = os_io_rx_evt(G_io_rx_buffer, sizeof(G_io_rx_buffer), NULL, true);
+    int           status = io_legacy_rx_evt();
 
     if (os_perso_is_pin_set() == BOLOS_TRUE && os_global_pin_is_validated() != BOLOS_TRUE) {
         err = SWO_SEC_PIN_15;
@@ -153,7 +216,7 @@ void io_seproxyhal_io_heartbeat(void)
             case OS_IO_PACKET_TYPE_USB_U2F_HID_APDU:
             case OS_IO_PACKET_TYPE_BLE_APDU:
             case OS_IO_PACKET_TYPE_NFC_APDU:
-                os_io_tx_cmd(G_io_rx_buffer[0], err_buffer, sizeof(err_buffer), 0);
+                io_legacy_tx_cmd(G_io_rx_buffer[0], err_buffer, sizeof(err_buffer));
                 break;
 
             default:
@@ -173,7 +236,7 @@ void io_seproxyhal_display_default(const bagl_element_t *element)
 
 void io_seph_send(const unsigned char *buffer, unsigned short length)
 {
-    os_io_tx_cmd(OS_IO_PACKET_TYPE_SEPH, buffer, length + 1, 0);
+    io_legacy_tx_cmd(OS_IO_PACKET_TYPE_SEPH, buffer, length + 1);
 }
 
 unsigned int io_seph_is_status_sent(void)
@@ -185,7 +248,7 @@ unsigned short io_seph_recv(unsigned char *buffer, unsigned short maxlength, uns
 {
     UNUSED(maxlength);
     UNUSED(flags);
-    int status = os_io_rx_evt(G_io_rx_buffer, sizeof(G_io_rx_buffer), NULL, true);
+    int status = io_legacy_rx_evt();
 
     if (status > 0) {
         switch (G_io_rx_buffer[0]) {
@@ -356,7 +419,7 @@ int io_legacy_apdu_rx(uint8_t handle_ux_events)
     int                      status      = 0;
     os_io_apdu_post_action_t post_action = OS_IO_APDU_POST_ACTION_NONE;
 
-    status = os_io_rx_evt(G_io_rx_buffer, sizeof(G_io_rx_buffer), NULL, true);
+    status = io_legacy_rx_evt();
 
     if (status > 0) {
         switch (G_io_rx_buffer[0]) {
@@ -398,7 +461,8 @@ int io_legacy_apdu_rx(uint8_t handle_ux_events)
                     bolos_err_t err   = SWO_SEC_PIN_15;
                     G_io_tx_buffer[0] = err >> 8;
                     G_io_tx_buffer[1] = err;
-                    status            = os_io_tx_cmd(io_os_legacy_apdu_type, G_io_tx_buffer, 2, 0);
+                    status            = io_legacy_tx_cmd(
+                        io_os_legacy_apdu_type, G_io_tx_buffer, 2);
                     io_os_legacy_apdu_type = APDU_TYPE_NONE;
                     if (status > 0) {
                         status = 0;
@@ -420,8 +484,8 @@ int io_legacy_apdu_rx(uint8_t handle_ux_events)
                     }
                     G_io_tx_buffer[buffer_out_length++] = err >> 8;
                     G_io_tx_buffer[buffer_out_length++] = err;
-                    status                              = os_io_tx_cmd(
-                        io_os_legacy_apdu_type, G_io_tx_buffer, buffer_out_length, 0);
+                    status                              = io_legacy_tx_cmd(
+                        io_os_legacy_apdu_type, G_io_tx_buffer, buffer_out_length);
                     io_os_legacy_apdu_type = APDU_TYPE_NONE;
                     if (post_action == OS_IO_APDU_POST_ACTION_EXIT) {
 #ifndef USE_OS_IO_STACK
@@ -478,7 +542,7 @@ int io_legacy_apdu_rx(uint8_t handle_ux_events)
 
 int io_legacy_apdu_tx(const unsigned char *buffer, unsigned short length)
 {
-    int status = os_io_tx_cmd(io_os_legacy_apdu_type, buffer, length, 0);
+    int status = io_legacy_tx_cmd(io_os_legacy_apdu_type, buffer, length);
 
     G_io_app.apdu_media    = IO_APDU_MEDIA_NONE;
     io_os_legacy_apdu_type = APDU_TYPE_NONE;
@@ -607,7 +671,7 @@ bool io_nfc_reader_send(const uint8_t      *cmd_data,
                         int                 timeout_ms)
 {
     G_io_reader_ctx.resp_callback = PIC(callback);
-    os_io_tx_cmd(APDU_TYPE_NFC, PIC(cmd_data), cmd_len, 0);
+    io_legacy_tx_cmd(APDU_TYPE_NFC, PIC(cmd_data), cmd_len);
 
     G_io_reader_ctx.response_received = false;
     G_io_reader_ctx.remaining_ms      = timeout_ms;
@@ -2,7 +2,8 @@
  * Dynamic allocator for an Application
  *
  * The provided API allows to hide the underlying memory allocator implementation.
- * and provide mechanisms for memory profiling (need flag HAVE_MEMORY_PROFILING).
+ * and provide mechanisms for memory profiling (need flag HAVE_MEMORY_PROFILING, and
+ * HAVE_MEMORY_PROFILING_RING to record the events in a binary ring buffer instead of printing them).
  */
 
 #include <stdint.h>
@@ -11,12 +12,41 @@
 #include "os_print.h"
 #include "mem_alloc.h"
 #include "app_mem_utils.h"
+#ifdef HAVE_MEMORY_PROFILING_RING
+#include "mem_profiling.h"
+#endif  // HAVE_MEMORY_PROFILING_RING
 
 static mem_ctx_t mem_utils_ctx = NULL;
 
 #ifdef HAVE_MEMORY_PROFILING
-#define MP_LOG_PREFIX "==MP "
-#endif
+#ifdef HAVE_MEMORY_PROFILING_RING
+// events are stored in a binary ring buffer, see mem_profiling.c
+#define MP_LOG_INIT(addr, size) mem_profiling_log(MEM_PROFILING_OP_INIT, addr, size, NULL, 0)
+#define MP_LOG_ALLOC(size, ptr, file, line) \
+    mem_profiling_log(MEM_PROFILING_OP_ALLOC, ptr, size, file, line)
+#define MP_LOG_PERSIST(size, ptr, file, line) \
+    mem_profiling_log(MEM_PROFILING_OP_PERSIST, ptr, size, file, line)
+#define MP_LOG_FREE(ptr, file, line) mem_profiling_log(MEM_PROFILING_OP_FREE, ptr, 0, file, line)
+#define MP_LOG_ARENA(arena, file, line) \
+    mem_profiling_log(MEM_PROFILING_OP_ARENA, (arena)->buffer, (arena)->high_water, file, line)
+#else  // HAVE_MEMORY_PROFILING_RING
+// events are printed, to be parsed by tools/valground.py
+#define MP_LOG_PREFIX           "==MP "
+#define MP_LOG_INIT(addr, size) PRINTF(MP_LOG_PREFIX "init;0x%p;%u\n", addr, size)
+#define MP_LOG_ALLOC(size, ptr, file, line) \
+    PRINTF(MP_LOG_PREFIX "alloc;%u;0x%p;%s:%u\n", size, ptr, file, line)
+#define MP_LOG_PERSIST(size, ptr, file, line) \
+    PRINTF(MP_LOG_PREFIX "persist;%u;0x%p;%s:%u\n", size, ptr, file, line)
+#define MP_LOG_FREE(ptr, file, line) PRINTF(MP_LOG_PREFIX "free;0x%p;%s:%u\n", ptr, file, line)
+#define MP_LOG_ARENA(arena, file, line)              \
+    PRINTF(MP_LOG_PREFIX "arena;%u;%u;0x%p;%s:%u\n", \
+           (arena)->size,                            \
+           (arena)->high_water,                      \
+           (arena)->buffer,                          \
+           file,                                     \
+           line)
+#endif  // HAVE_MEMORY_PROFILING_RING
+#endif  // HAVE_MEMORY_PROFILING
 
 /**
  * @brief Initializes the App heap buffer
@@ -31,7 +61,7 @@ bool mem_utils_init(void *heap_start, size_t heap_size)
 {
     mem_utils_ctx = mem_init(heap_start, heap_size);
 #ifdef HAVE_MEMORY_PROFILING
-    PRINTF(MP_LOG_PREFIX "init;0x%p;%u\n", heap_start, heap_size);
+    MP_LOG_INIT(heap_start, heap_size);
 #endif
     return mem_utils_ctx != NULL;
 }
@@ -40,29 +70,34 @@ bool mem_utils_init(void *heap_start, size_t heap_size)
  * @brief Internal implementation of memory allocation
  *
  * @param[in] size in bytes to allocate (must be > 0)
- * @param[in] permanent if true, the allocation is never freed (for profiling only)
+ * @param[in] permanent if true, the allocation is never freed, and is taken from the top of the
+ *            heap
  * @param[in] file source file requesting the allocation (for profiling only)
  * @param[in] line line in the source file requesting the allocation (for profiling only)
  * @return either a valid address if successful, or NULL if failed
  */
 void *mem_utils_alloc(size_t size, bool permanent, const char *file, int line)
 {
-    UNUSED(permanent);
     UNUSED(file);
     UNUSED(line);
     void *ptr = NULL;
 
-    ptr = mem_alloc(mem_utils_ctx, size);
+    if (permanent) {
+        ptr = mem_alloc_permanent(mem_utils_ctx, size);
+    }
+    else {
+        ptr = mem_alloc(mem_utils_ctx, size);
+    }
 #ifdef HAVE_MEMORY_PROFILING
     // Only log successful allocations. A failed allocation (ptr == NULL, e.g. out of memory) must
     // not be recorded, otherwise the profiler tracks a phantom live allocation at address 0x0 that
     // is never freed (there is nothing to free) and reports it as a spurious memory leak.
     if (ptr != NULL) {
         if (permanent) {
-            PRINTF(MP_LOG_PREFIX "persist;%u;0x%p;%s:%u\n", size, ptr, file, line);
+            MP_LOG_PERSIST(size, ptr, file, line);
         }
         else {
-            PRINTF(MP_LOG_PREFIX "alloc;%u;0x%p;%s:%u\n", size, ptr, file, line);
+            MP_LOG_ALLOC(size, ptr, file, line);
         }
     }
 #endif
@@ -87,15 +122,16 @@ void *mem_utils_realloc(void *ptr, size_t size, const char *file, int line)
 
 #ifdef HAVE_MEMORY_PROFILING
     if (ptr != NULL && size == 0) {
-        PRINTF(MP_LOG_PREFIX "free;0x%p;%s:%u\n", ptr, file, line);
+        MP_LOG_FREE(ptr, file, line);
     }
     else if (new_ptr != NULL) {
         if (ptr == NULL) {
-            PRINTF(MP_LOG_PREFIX "alloc;%u;0x%p;%s:%u\n", size, new_ptr, file, line);
+            MP_LOG_ALLOC(size, new_ptr, file, line);
         }
-        else if (ptr != new_ptr) {
-            PRINTF(MP_LOG_PREFIX "free;0x%p;%s:%u\n", ptr, file, line);
-            PRINTF(MP_LOG_PREFIX "alloc;%u;0x%p;%s:%u\n", size, new_ptr, file, line);
+        else {
+            // Also logged when the chunk is resized in place, so that its new size is known
+            MP_LOG_FREE(ptr, file, line);
+            MP_LOG_ALLOC(size, new_ptr, file, line);
         }
     }
 #endif
@@ -117,7 +153,7 @@ void mem_utils_free(void *ptr, const char *file, int line)
         return;
     }
 #ifdef HAVE_MEMORY_PROFILING
-    PRINTF(MP_LOG_PREFIX "free;0x%p;%s:%u\n", ptr, file, line);
+    MP_LOG_FREE(ptr, file, line);
 #endif
     mem_free(mem_utils_ctx, ptr);
 }
@@ -127,7 +163,8 @@ void mem_utils_free(void *ptr, const char *file, int line)
  *
  * @param[out] buffer pointer to the buffer to allocate
  * @param[in] size (in bytes) to allocate
- * @param[in] permanent if true, the allocation is never freed (for profiling only)
+ * @param[in] permanent if true, the allocation is never freed, and is taken from the top of the
+ *            heap
  * @param[in] file source file requesting the allocation (for profiling only)
  * @param[in] line line in the source file requesting the allocation (for profiling only)
  * @return true if the allocation was successful, false otherwise
@@ -181,3 +218,63 @@ char *mem_utils_strdup(const char *src, const char *file, int line)
     }
     return dst;
 }
+
+/**
+ * @brief Internal implementation of arena creation
+ *
+ * @param[out] arena arena to initialize
+ * @param[in] size in bytes of the arena backing buffer
+ * @param[in] file source file requesting the allocation (for profiling only)
+ * @param[in] line line in the source file requesting the allocation (for profiling only)
+ * @return true if the allocation was successful, false otherwise
+ */
+bool mem_utils_arena_begin(mem_arena_t *arena, size_t size, const char *file, int line)
+{
+    UNUSED(file);
+    UNUSED(line);
+    if (!mem_arena_begin(mem_utils_ctx, arena, size)) {
+        return false;
+    }
+#ifdef HAVE_MEMORY_PROFILING
+    MP_LOG_ALLOC(size, arena->buffer, file, line);
+#endif
+    return true;
+}
+
+/**
+ * @brief Internal implementation of arena reset
+ *
+ * @param[in,out] arena arena to reset
+ * @param[in] file source file requesting the reset (for profiling only)
+ * @param[in] line line in the source file requesting the reset (for profiling only)
+ */
+void mem_utils_arena_reset(mem_arena_t *arena, const char *file, int line)
+{
+    UNUSED(file);
+    UNUSED(line);
+#ifdef HAVE_MEMORY_PROFILING
+    MP_LOG_ARENA(arena, file, line);
+#endif
+    mem_arena_reset(arena);
+}
+
+/**
+ * @brief Internal implementation of arena release
+ *
+ * @param[in,out] arena arena to release, with its backing buffer
+ * @param[in] file source file requesting the release (for profiling only)
+ * @param[in] line line in the source file requesting the release (for profiling only)
+ */
+void mem_utils_arena_end(mem_arena_t *arena, const char *file, int line)
+{
+    UNUSED(file);
+    UNUSED(line);
+    if (arena->buffer == NULL) {
+        return;
+    }
+#ifdef HAVE_MEMORY_PROFILING
+    MP_LOG_ARENA(arena, file, line);
+    MP_LOG_FREE(arena->buffer, file, line);
+#endif
+    mem_arena_end(mem_utils_ctx, arena);
+}
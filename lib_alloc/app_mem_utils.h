@@ -3,6 +3,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include "mem_arena.h"
 
 #ifdef HAVE_MEMORY_PROFILING
 #define ALLOC_FILE __FILE__
@@ -21,6 +22,11 @@
 #define APP_MEM_CALLOC(ptr, size)    mem_utils_calloc(ptr, size, false, ALLOC_FILE, ALLOC_LINE)
 #define APP_MEM_PERMANENT(ptr, size) mem_utils_calloc(ptr, size, true, ALLOC_FILE, ALLOC_LINE)
 
+#define APP_MEM_ARENA_BEGIN(arena, size) mem_utils_arena_begin(arena, size, ALLOC_FILE, ALLOC_LINE)
+#define APP_MEM_ARENA_ALLOC(arena, size) mem_arena_alloc(arena, size)
+#define APP_MEM_ARENA_RESET(arena)       mem_utils_arena_reset(arena, ALLOC_FILE, ALLOC_LINE)
+#define APP_MEM_ARENA_END(arena)         mem_utils_arena_end(arena, ALLOC_FILE, ALLOC_LINE)
+
 bool  mem_utils_init(void *heap_start, size_t heap_size);
 void *mem_utils_alloc(size_t size, bool permanent, const char *file, int line);
 void *mem_utils_realloc(void *ptr, size_t size, const char *file, int line);
@@ -28,3 +34,7 @@ void  mem_utils_free(void *ptr, const char *file, int line);
 void  mem_utils_free_and_null(void **buffer, const char *file, int line);
 char *mem_utils_strdup(const char *s, const char *file, int line);
 bool  mem_utils_calloc(void **buffer, size_t size, bool permanent, const char *file, int line);
+
+bool mem_utils_arena_begin(mem_arena_t *arena, size_t size, const char *file, int line);
+void mem_utils_arena_reset(mem_arena_t *arena, const char *file, int line);
+void mem_utils_arena_end(mem_arena_t *arena, const char *file, int line);
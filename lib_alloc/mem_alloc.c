@@ -29,9 +29,17 @@
 #define FREE_CHUNK_HEADER_SIZE  8
 // maximum block size storable in the 15-bit header size field
 #define MAX_BLOCK_SIZE          0x7FFF
+
+// same for the wide chunk headers, used for heaps bigger than 32 kBytes
+#define WIDE_ALLOC_CHUNK_HEADER_SIZE 8
+#define WIDE_FREE_CHUNK_HEADER_SIZE  16
+#define WIDE_MAX_BLOCK_SIZE          0x7FFFFFFF
+
 // size of heap header
 #define HEAP_HEADER_SIZE \
     ((sizeof(heap_t) + PAYLOAD_DATA_ALIGNEMENT - 1) & ~(PAYLOAD_DATA_ALIGNEMENT - 1))
+// biggest heap addressable with the compact chunk headers
+#define MAX_COMPACT_HEAP_SIZE (0x7FF8 + HEAP_HEADER_SIZE)
 
 // number of 2^N segments aggregated as linear
 #define NB_LINEAR_SEGMENTS 5
@@ -47,18 +55,58 @@
 - n: 2^(n+5)-(2^(n+6)-1) bytes
 - 9: 16384-32767 bytes
 */
-#define NB_MAX_SEGMENTS    10
+#ifdef HAVE_MEM_ALLOC_WIDE_HEADER
+// 16 segments enable using up to ~2M bytes chunks with the wide chunk headers
+#define NB_MAX_SEGMENTS 16
+#define MAX_HEAP_SIZE   (0x1FFFF8 + HEAP_HEADER_SIZE)
+#else  // HAVE_MEM_ALLOC_WIDE_HEADER
+#define NB_MAX_SEGMENTS 10
+#define MAX_HEAP_SIZE   MAX_COMPACT_HEAP_SIZE
+#endif  // HAVE_MEM_ALLOC_WIDE_HEADER
 // 4 sub-segments to have a better segregation of each segments
 #define NB_SUB_SEGMENTS    4
+// max number of chunks checked in the sub-segment holding the requested size, before falling back
+// to the next non-empty sub-segment (where any chunk is big enough)
+#define NB_GOOD_FIT_CANDIDATES 4
 
 // index is basically the offset in u64 from beginning of full heap buffer
 #define GET_PTR(_heap, index) ((header_t *) (((uint8_t *) _heap) + ((index) << 3)))
 #define GET_IDX(_heap, _ptr)  ((((uint8_t *) (_ptr)) - ((uint8_t *) _heap)) >> 3)
-#define GET_PREV(_heap, _ptr) ((header_t *) (((uint8_t *) _heap) + ((_ptr)->fprev << 3)))
-#define GET_NEXT(_heap, _ptr) ((header_t *) (((uint8_t *) _heap) + ((_ptr)->fnext << 3)))
+#define GET_PREV(_heap, _ptr) GET_PTR(_heap, GET_FIELD(_heap, _ptr, fprev))
+#define GET_NEXT(_heap, _ptr) GET_PTR(_heap, GET_FIELD(_heap, _ptr, fnext))
+
+// The chunk headers are either compact (header_t) or wide (wide_header_t), depending on the heap
+// size given to mem_init(). Without HAVE_MEM_ALLOC_WIDE_HEADER, they are always compact.
+#ifdef HAVE_MEM_ALLOC_WIDE_HEADER
+#define IS_WIDE(_heap) ((_heap)->wide)
+#else  // HAVE_MEM_ALLOC_WIDE_HEADER
+#define IS_WIDE(_heap) false
+#endif  // HAVE_MEM_ALLOC_WIDE_HEADER
+#define GET_FIELD(_heap, _ptr, _field) \
+    (IS_WIDE(_heap) ? ((wide_header_t *) (_ptr))->_field : (_ptr)->_field)
+#define SET_FIELD(_heap, _ptr, _field, _value)             \
+    do {                                                   \
+        if (IS_WIDE(_heap)) {                              \
+            ((wide_header_t *) (_ptr))->_field = (_value); \
+        }                                                  \
+        else {                                             \
+            (_ptr)->_field = (_value);                     \
+        }                                                  \
+    } while (0)
+#define ALLOC_HEADER_SIZE(_heap) \
+    (IS_WIDE(_heap) ? WIDE_ALLOC_CHUNK_HEADER_SIZE : ALLOC_CHUNK_HEADER_SIZE)
+#define FREE_HEADER_SIZE(_heap) \
+    (IS_WIDE(_heap) ? WIDE_FREE_CHUNK_HEADER_SIZE : FREE_CHUNK_HEADER_SIZE)
+// biggest size that can be requested, so that the aligned block size fits in the header
+#define MAX_ALLOC_SIZE(_heap)                                          \
+    ((size_t) ((IS_WIDE(_heap) ? WIDE_MAX_BLOCK_SIZE : MAX_BLOCK_SIZE) \
+               - (PAYLOAD_DATA_ALIGNEMENT - 1 + ALLOC_HEADER_SIZE(_heap))))
 
 #define GET_SEGMENT(_size) MAX(NB_LINEAR_SEGMENTS, (31 - __builtin_clz(size)))
 
+// end of the heap buffer
+#define GET_END(_heap) ((void *) (((uint8_t *) _heap) + (_heap)->size))
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -72,12 +120,49 @@ typedef struct header_s {
     uint16_t fnext;  ///< next free chunk in the same segment
 } header_t;
 
+// same as header_t, for the heaps bigger than 32 kBytes
+typedef struct wide_header_s {
+    uint32_t size : 31;
+    uint32_t allocated : 1;
+
+    uint32_t phys_prev;  ///< physical previous chunk
+
+    uint32_t fprev;  ///< previous free chunk in the same segment
+    uint32_t fnext;  ///< next free chunk in the same segment
+} wide_header_t;
+
+// index of a chunk (offset in u64 from beginning of full heap buffer)
+#ifdef HAVE_MEM_ALLOC_WIDE_HEADER
+typedef uint32_t chunk_idx_t;
+#else   // HAVE_MEM_ALLOC_WIDE_HEADER
+typedef uint16_t chunk_idx_t;
+#endif  // HAVE_MEM_ALLOC_WIDE_HEADER
+
+// The heap end is stored as a size rather than a pointer, to leave room for the boundary of the
+// permanent region without growing the header on 64-bit hosts
 typedef struct {
-    void    *end;      ///< end of headp buffer, for consistency check
-    size_t   nb_segs;  ///< actual number of used segments
-    uint16_t free_segments[NB_MAX_SEGMENTS * NB_SUB_SEGMENTS];
+    chunk_idx_t size;           ///< size of the heap buffer, for consistency check
+    chunk_idx_t permanent_idx;  ///< lowest chunk of the permanent region, 0 if empty
+    uint16_t    seg_bitmap;     ///< bit n is set if a sub-segment of segment n is not empty
+    /// bit n of this array is set if free_segments[n] is not empty (2 segments per byte)
+    uint8_t     sub_seg_bitmaps[NB_MAX_SEGMENTS * NB_SUB_SEGMENTS / 8];
+    uint8_t     nb_segs;  ///< actual number of used segments
+    chunk_idx_t free_segments[NB_MAX_SEGMENTS * NB_SUB_SEGMENTS];
+    chunk_idx_t handles_idx;  ///< chunk holding the handle table, 0 if none
+    uint8_t     nb_handles;   ///< number of entries in the handle table
+#ifdef HAVE_MEM_ALLOC_WIDE_HEADER
+    /// chunk headers are wide_header_t (heap bigger than 32 kBytes)
+    bool wide;
+#endif  // HAVE_MEM_ALLOC_WIDE_HEADER
 } heap_t;
 
+// entry of the handle table, the handle being its index + 1
+typedef struct {
+    chunk_idx_t chunk_idx;  ///< chunk of the buffer, 0 if the entry is unused
+    uint8_t     nb_locks;   ///< the chunk can be moved by mem_compact() only if 0
+    uint8_t     reserved;
+} handle_entry_t;
+
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -89,8 +174,14 @@ typedef struct {
 /**********************
  *   LOCAL FUNCTIONS
  **********************/
-static inline size_t align_alloc_size(size_t size)
+static inline size_t align_alloc_size(heap_t *heap, size_t size)
 {
+    if (IS_WIDE(heap)) {
+        // the 8-byte header keeps the payload aligned, only the size has to be aligned
+        size += PAYLOAD_DATA_ALIGNEMENT - 1;
+        size &= ~(PAYLOAD_DATA_ALIGNEMENT - 1);
+        return size + WIDE_ALLOC_CHUNK_HEADER_SIZE;
+    }
     // Add alignment - 1 to prepare for rounding up if needed
     // This trick ensures already aligned sizes are not changed
     size += PAYLOAD_ALIGNEMENT - 1;
@@ -176,74 +267,112 @@ static inline int seglist_index_up(heap_t *heap, size_t size)
     return seg * NB_SUB_SEGMENTS + sub_segment;
 }
 
+// returns the bitmap of the non-empty sub-segments of the given segment
+static inline uint32_t get_sub_seg_bitmap(heap_t *heap, size_t seg)
+{
+    return (heap->sub_seg_bitmaps[seg / 2] >> ((seg & 1) * NB_SUB_SEGMENTS))
+           & ((1 << NB_SUB_SEGMENTS) - 1);
+}
+
+// returns the index of the first non-empty free list at or after the given one, or -1 if none
+static inline int find_free_segment(heap_t *heap, int seg_index)
+{
+    size_t   seg  = seg_index / NB_SUB_SEGMENTS;
+    uint32_t subs = get_sub_seg_bitmap(heap, seg) & (~0U << (seg_index % NB_SUB_SEGMENTS));
+
+    if (subs == 0) {
+        // nothing in this segment, take the first sub-segment of the next non-empty one
+        uint32_t segs = heap->seg_bitmap & (~0U << (seg + 1));
+        if (segs == 0) {
+            return -1;
+        }
+        seg  = __builtin_ctz(segs);
+        subs = get_sub_seg_bitmap(heap, seg);
+    }
+    return seg * NB_SUB_SEGMENTS + __builtin_ctz(subs);
+}
+
 // remove item from linked list
-static inline void list_remove(heap_t *heap, uint16_t *first_free, uint16_t elem)
+static inline void list_remove(heap_t *heap, int seg_index, chunk_idx_t elem)
 {
-    header_t *elem_ptr = GET_PTR(heap, elem);
+    chunk_idx_t *first_free = &heap->free_segments[seg_index];
+    header_t *elem_ptr   = GET_PTR(heap, elem);
     // if was the first, set a new first
     if (*first_free == elem) {
-        *first_free = elem_ptr->fnext;
+        *first_free = GET_FIELD(heap, elem_ptr, fnext);
         // if the current first was not alone
         if (*first_free) {
-            GET_PTR(heap, *first_free)->fprev = 0;
+            SET_FIELD(heap, GET_PTR(heap, *first_free), fprev, 0);
+        }
+        else {
+            // the list is now empty
+            size_t seg = seg_index / NB_SUB_SEGMENTS;
+            heap->sub_seg_bitmaps[seg_index / 8] &= ~(1 << (seg_index % 8));
+            if (get_sub_seg_bitmap(heap, seg) == 0) {
+                heap->seg_bitmap &= ~(1 << seg);
+            }
         }
         return;
     }
     // link previous to following, if existing previous
-    if (elem_ptr->fprev) {
-        GET_PREV(heap, elem_ptr)->fnext = elem_ptr->fnext;
+    if (GET_FIELD(heap, elem_ptr, fprev)) {
+        SET_FIELD(heap, GET_PREV(heap, elem_ptr), fnext, GET_FIELD(heap, elem_ptr, fnext));
     }
     // link following to previous, if existing following
-    if (elem_ptr->fnext) {
-        GET_NEXT(heap, elem_ptr)->fprev = elem_ptr->fprev;
+    if (GET_FIELD(heap, elem_ptr, fnext)) {
+        SET_FIELD(heap, GET_NEXT(heap, elem_ptr), fprev, GET_FIELD(heap, elem_ptr, fprev));
     }
 }
 
 // add item in LIFO
 static inline void list_push(heap_t *heap, header_t *header)
 {
-    int seg_index = seglist_index(heap, header->size);
+    int seg_index = seglist_index(heap, GET_FIELD(heap, header, size));
     if (seg_index < 0) {
         return;
     }
-    uint16_t first_idx = heap->free_segments[seg_index];
+    chunk_idx_t first_idx = heap->free_segments[seg_index];
     // if it's already the first item, nothing to do
     if (first_idx == GET_IDX(heap, header)) {
         return;
     }
     // link this new first to following (previous first)
-    header->fnext     = first_idx;
-    header->fprev     = 0;
-    header->allocated = 0;
+    SET_FIELD(heap, header, fnext, first_idx);
+    SET_FIELD(heap, header, fprev, 0);
+    SET_FIELD(heap, header, allocated, 0);
     // link following (previous first) to new first
     if (first_idx != 0) {
         header_t *first = GET_PTR(heap, first_idx);
-        first->fprev    = GET_IDX(heap, header);
+        SET_FIELD(heap, first, fprev, GET_IDX(heap, header));
     }
     // replace new first
     heap->free_segments[seg_index] = GET_IDX(heap, header);
+    heap->sub_seg_bitmaps[seg_index / 8] |= 1 << (seg_index % 8);
+    heap->seg_bitmap |= 1 << (seg_index / NB_SUB_SEGMENTS);
 }
 
 // ensure the chunk is valid
 static inline void ensure_chunk_valid(heap_t *heap, header_t *header)
 {
-    uint8_t *block = (uint8_t *) header;
+    uint8_t    *block     = (uint8_t *) header;
+    size_t      size      = GET_FIELD(heap, header, size);
+    chunk_idx_t phys_prev = GET_FIELD(heap, header, phys_prev);
     // ensure size is valid (multiple of pointers) and minimal size of 4 pointers)
-    if ((header->size & (PAYLOAD_ALIGNEMENT - 1)) || (header->size < FREE_CHUNK_HEADER_SIZE)
-        || ((block + header->size) > (uint8_t *) heap->end)) {
-        PRINTF("invalid size: header->size  = %d!\n", header->size);
+    if ((size & (PAYLOAD_ALIGNEMENT - 1)) || (size < FREE_HEADER_SIZE(heap))
+        || ((block + size) > (uint8_t *) GET_END(heap))) {
+        PRINTF("invalid size: header->size  = %d!\n", (int) size);
         THROW(EXCEPTION_CORRUPT);
     }
     //  ensure phys_prev is valid
-    if (header->phys_prev != 0) {
-        header_t *prev = GET_PTR(heap, header->phys_prev);
+    if (phys_prev != 0) {
+        header_t *prev = GET_PTR(heap, phys_prev);
         block          = (uint8_t *) heap;
-        if (((uint8_t *) prev < &block[HEAP_HEADER_SIZE]) || ((void *) prev > heap->end)) {
+        if (((uint8_t *) prev < &block[HEAP_HEADER_SIZE]) || ((void *) prev > GET_END(heap))) {
             PRINTF("corrupted prev_chunk\n");
             THROW(EXCEPTION_CORRUPT);
         }
         // ensure that next of prev is current
-        if ((((uint8_t *) prev) + prev->size) != (uint8_t *) header) {
+        if ((((uint8_t *) prev) + GET_FIELD(heap, prev, size)) != (uint8_t *) header) {
             PRINTF("corrupted prev_chunk\n");
             THROW(EXCEPTION_CORRUPT);
         }
@@ -253,36 +382,37 @@ static inline void ensure_chunk_valid(heap_t *heap, header_t *header)
 // coalesce the two given chunks
 static header_t *coalesce(heap_t *heap, header_t *header, header_t *neighbour)
 {
-    uint16_t neighbour_idx = GET_IDX(heap, neighbour);
+    chunk_idx_t neighbour_idx = GET_IDX(heap, neighbour);
     ensure_chunk_valid(heap, neighbour);
 
     // if not allocated, coalesce
-    if (!neighbour->allocated) {
-        int seg_index = seglist_index(heap, neighbour->size);
+    if (!GET_FIELD(heap, neighbour, allocated)) {
+        int seg_index = seglist_index(heap, GET_FIELD(heap, neighbour, size));
         // remove this neighbour from its free list
         if (seg_index >= 0) {
-            list_remove(heap, &heap->free_segments[seg_index], neighbour_idx);
+            list_remove(heap, seg_index, neighbour_idx);
         }
         // link the current next physical chunk (if existing) to this new chunk
         header_t *next;
+        size_t    size = GET_FIELD(heap, header, size) + GET_FIELD(heap, neighbour, size);
         if (header < neighbour) {
-            next = (header_t *) (((uint8_t *) neighbour) + neighbour->size);
-            if ((void *) next < heap->end) {
-                next->phys_prev = GET_IDX(heap, header);
+            next = (header_t *) (((uint8_t *) neighbour) + GET_FIELD(heap, neighbour, size));
+            if ((void *) next < GET_END(heap)) {
+                SET_FIELD(heap, next, phys_prev, GET_IDX(heap, header));
             }
-            header->size += neighbour->size;
+            SET_FIELD(heap, header, size, size);
             // clean-up neighbour to avoid leaking
-            memset(neighbour, 0, sizeof(*neighbour));
+            memset(neighbour, 0, FREE_HEADER_SIZE(heap));
         }
         else {
-            next = (header_t *) (((uint8_t *) header) + header->size);
+            next = (header_t *) (((uint8_t *) header) + GET_FIELD(heap, header, size));
             // ensure next is valid (inside the  heap buffer) before linking it
-            if ((void *) next < heap->end) {
-                next->phys_prev = neighbour_idx;
+            if ((void *) next < GET_END(heap)) {
+                SET_FIELD(heap, next, phys_prev, neighbour_idx);
             }
-            neighbour->size += header->size;
+            SET_FIELD(heap, neighbour, size, size);
             // clean-up header to avoid leaking
-            memset(header, 0, sizeof(*header));
+            memset(header, 0, FREE_HEADER_SIZE(heap));
             // header points now to neighbour
             header = neighbour;
         }
@@ -290,6 +420,71 @@ static header_t *coalesce(heap_t *heap, header_t *header, header_t *neighbour)
     return header;
 }
 
+// split the given allocated chunk to the given size, if the remainder can be a free chunk
+static void split_chunk(heap_t *heap, header_t *header, size_t size)
+{
+    uint8_t *block     = (uint8_t *) header;
+    size_t   remainder = GET_FIELD(heap, header, size) - size;
+
+    if (remainder >= FREE_HEADER_SIZE(heap)) {
+        // Save pointer to next physical chunk
+        header_t *next = (header_t *) &block[GET_FIELD(heap, header, size)];
+        // Create new free chunk in the remaining space, located just after the resized block
+        header_t *new_free = (header_t *) &block[size];
+        SET_FIELD(heap, new_free, size, remainder);
+        // The new chunk predecessor is the resized chunk (still the same)
+        SET_FIELD(heap, new_free, phys_prev, GET_IDX(heap, header));
+        // Link the current next physical chunk to this new chunk (if existing)
+        if ((void *) next < GET_END(heap)) {
+            SET_FIELD(heap, next, phys_prev, GET_IDX(heap, new_free));
+        }
+        list_push(heap, new_free);
+        // Adjust the size of the allocated block
+        SET_FIELD(heap, header, size, size);
+    }
+}
+
+// returns the entry of the given handle, or NULL if invalid
+static handle_entry_t *get_handle_entry(heap_t *heap, mem_handle_t handle)
+{
+    handle_entry_t *entries;
+
+    if ((heap->handles_idx == 0) || (handle == MEM_INVALID_HANDLE)
+        || (handle > heap->nb_handles)) {
+        return NULL;
+    }
+    entries = (handle_entry_t *) (((uint8_t *) GET_PTR(heap, heap->handles_idx))
+                                  + ALLOC_HEADER_SIZE(heap));
+    if (entries[handle - 1].chunk_idx == 0) {
+        return NULL;
+    }
+    return &entries[handle - 1];
+}
+
+// returns the entry of the handle owning the given chunk, or NULL if not allocated by handle
+static handle_entry_t *find_handle_entry(heap_t *heap, chunk_idx_t chunk_idx)
+{
+    for (mem_handle_t handle = 1; handle <= heap->nb_handles; handle++) {
+        handle_entry_t *entry = get_handle_entry(heap, handle);
+        if ((entry != NULL) && (entry->chunk_idx == chunk_idx)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+// turns the given gap into a free chunk, ending at the given (non-free) chunk
+static void close_gap(heap_t *heap, header_t *gap, chunk_idx_t prev_idx, header_t *end)
+{
+    SET_FIELD(heap, gap, size, ((uint8_t *) end) - ((uint8_t *) gap));
+    SET_FIELD(heap, gap, allocated, 0);
+    SET_FIELD(heap, gap, phys_prev, prev_idx);
+    if ((void *) end < GET_END(heap)) {
+        SET_FIELD(heap, end, phys_prev, GET_IDX(heap, gap));
+    }
+    list_push(heap, gap);
+}
+
 static bool parse_callback(void *data, uint8_t *addr, bool allocated, size_t size)
 {
     mem_stat_t *stat = (mem_stat_t *) data;
@@ -321,7 +516,9 @@ static bool parse_callback(void *data, uint8_t *addr, bool allocated, size_t siz
  *
  * @param heap_start address of the heap to use
  * @param heap_size size in bytes of the heap to use. It must be a multiple of 8, and at least 200
- * bytes but less than 32kBytes (max is exactly 32856 bytes)
+ * bytes but less than 32kBytes (max is exactly 32856 bytes). With HAVE_MEM_ALLOC_WIDE_HEADER, it
+ * can be up to 2MBytes: bigger heaps than 32856 bytes then use wider chunk headers (8 bytes
+ * instead of 4 for allocated chunks)
  * @return the context to use for further calls, or NULL if failling
  */
 mem_ctx_t mem_init(void *heap_start, size_t heap_size)
@@ -335,23 +532,32 @@ mem_ctx_t mem_init(void *heap_start, size_t heap_size)
 
     // size must be a multiple of 8, and at least 200 bytes
     if ((heap_size & (FREE_CHUNK_HEADER_SIZE - 1)) || (heap_size < 200)
-        || (heap_size > (0x7FF8 + HEAP_HEADER_SIZE))) {
+        || (heap_size > MAX_HEAP_SIZE)) {
         return NULL;
     }
+#ifdef HAVE_MEM_ALLOC_WIDE_HEADER
+    // the compact headers are kept for the heaps they can address
+    heap->wide = (heap_size > MAX_COMPACT_HEAP_SIZE);
+#endif  // HAVE_MEM_ALLOC_WIDE_HEADER
 
-    heap->end = ((uint8_t *) heap_start) + heap_size;
+    heap->size          = heap_size;
+    heap->permanent_idx = 0;
+    heap->handles_idx   = 0;
+    heap->nb_handles    = 0;
 
     // compute number of segments
     heap->nb_segs = 31 - __builtin_clz(heap_size - HEAP_HEADER_SIZE) - NB_LINEAR_SEGMENTS + 1;
     if (heap->nb_segs > NB_MAX_SEGMENTS) {
         return NULL;
     }
-    memset(heap->free_segments, 0, heap->nb_segs * NB_SUB_SEGMENTS * sizeof(uint16_t));
+    memset(heap->free_segments, 0, heap->nb_segs * NB_SUB_SEGMENTS * sizeof(chunk_idx_t));
+    memset(heap->sub_seg_bitmaps, 0, sizeof(heap->sub_seg_bitmaps));
+    heap->seg_bitmap = 0;
 
     // initiate free chunk LIFO with the whole heap as a free chunk
-    header_t *first_free  = (header_t *) (((uint8_t *) heap) + HEAP_HEADER_SIZE);
-    first_free->size      = heap_size - HEAP_HEADER_SIZE;
-    first_free->phys_prev = 0;
+    header_t *first_free = (header_t *) (((uint8_t *) heap) + HEAP_HEADER_SIZE);
+    SET_FIELD(heap, first_free, size, heap_size - HEAP_HEADER_SIZE);
+    SET_FIELD(heap, first_free, phys_prev, 0);
     list_push(heap, first_free);
 
     return (mem_ctx_t) heap_start;
@@ -378,13 +584,12 @@ void *mem_alloc(mem_ctx_t ctx, size_t nb_bytes)
 
     // Reject sizes that would overflow the unsigned arithmetic below
     // or exceed the maximum chunk size storable in the header.
-    if (nb_bytes > MAX_BLOCK_SIZE
-                       - (PAYLOAD_ALIGNEMENT - 1 + ALLOC_CHUNK_HEADER_SIZE + PAYLOAD_ALIGNEMENT)) {
+    if (nb_bytes > MAX_ALLOC_SIZE(heap)) {
         return NULL;
     }
 
     // Adjust size to include header and satisfy alignment requirements, etc.
-    nb_bytes = align_alloc_size(nb_bytes);
+    nb_bytes = align_alloc_size(heap, nb_bytes);
 
     // get the segment sure to be holding this size
     // if nb_bytes == 2^n , all chunks in [2^n: 2^(n+1)[ are ok
@@ -393,54 +598,143 @@ void *mem_alloc(mem_ctx_t ctx, size_t nb_bytes)
     if (seg < 0) {
         return NULL;
     }
-    // Loop through all increasing size segments
-    while ((size_t) seg < (heap->nb_segs * NB_SUB_SEGMENTS)) {
-        uint16_t chunk_idx = heap->free_segments[seg];
-        // if this segment is not empty, it must contain a big-enough chunk
-        if (chunk_idx != 0) {
-            header_t *header = GET_PTR(heap, chunk_idx);
 
-            //  ensure chunk is consistent
+    chunk_idx_t chunk_idx = 0;
+    // good fit: the sub-segment holding this size may contain a big-enough chunk, smaller than
+    // any chunk of the following sub-segments. Only its first chunks are checked.
+    int fit_seg = seglist_index(heap, nb_bytes);
+    if ((fit_seg >= 0) && (fit_seg != seg)) {
+        chunk_idx_t candidate = heap->free_segments[fit_seg];
+        for (uint8_t i = 0; (i < NB_GOOD_FIT_CANDIDATES) && (candidate != 0); i++) {
+            header_t *header = GET_PTR(heap, candidate);
             ensure_chunk_valid(heap, header);
-            // this block shall always be big enough
-            if (nb_bytes > header->size) {
-                // probably a big issue, maybe necessary to throw an exception
-                return NULL;
-            }
-            uint8_t *block = (uint8_t *) header;
-
-            // remove the block from the segregated list
-            list_remove(heap, &heap->free_segments[seg], chunk_idx);
-            // We could turn the excess bytes into a new free block
-            // the minimum size is the size of an empty chunk
-            if (header->size >= (nb_bytes + FREE_CHUNK_HEADER_SIZE)) {
-                header_t *new_free = (header_t *) &block[nb_bytes];
-                new_free->size     = header->size - nb_bytes;
-                // link this new chunk to previous (found) one
-                new_free->phys_prev = chunk_idx;
-                // link the current next physical chunk to this new chunk (if existing)
-                header_t *next = (header_t *) &block[header->size];
-                if ((void *) next < heap->end) {
-                    next->phys_prev = GET_IDX(heap, new_free);
-                }
-                list_push(heap, new_free);
-                // change size only if new chunk is created
-                header->size = nb_bytes;
+            if (GET_FIELD(heap, header, size) >= nb_bytes) {
+                chunk_idx = candidate;
+                seg       = fit_seg;
+                break;
             }
+            candidate = GET_FIELD(heap, header, fnext);
+        }
+    }
+    if (chunk_idx == 0) {
+        // any chunk of the first non-empty sub-segment from this one is big enough
+        seg = find_free_segment(heap, seg);
+        if (seg < 0) {
+            return NULL;
+        }
+        chunk_idx = heap->free_segments[seg];
+    }
 
-            // Update the chunk's header to set the allocated bit
-            header->allocated = 0x1;
+    header_t *header = GET_PTR(heap, chunk_idx);
 
-            // clean-up previous empty header info
-            header->fnext = header->fprev = 0;
+    //  ensure chunk is consistent
+    ensure_chunk_valid(heap, header);
+    // this block shall always be big enough
+    if (nb_bytes > GET_FIELD(heap, header, size)) {
+        // probably a big issue, maybe necessary to throw an exception
+        return NULL;
+    }
+    uint8_t *block = (uint8_t *) header;
 
-            // Return a pointer to the payload
-            return block + ALLOC_CHUNK_HEADER_SIZE;
+    // remove the block from the segregated list
+    list_remove(heap, seg, chunk_idx);
+    // We could turn the excess bytes into a new free block
+    // the minimum size is the size of an empty chunk
+    if (GET_FIELD(heap, header, size) >= (nb_bytes + FREE_HEADER_SIZE(heap))) {
+        header_t *new_free = (header_t *) &block[nb_bytes];
+        SET_FIELD(heap, new_free, size, GET_FIELD(heap, header, size) - nb_bytes);
+        // link this new chunk to previous (found) one
+        SET_FIELD(heap, new_free, phys_prev, chunk_idx);
+        // link the current next physical chunk to this new chunk (if existing)
+        header_t *next = (header_t *) &block[GET_FIELD(heap, header, size)];
+        if ((void *) next < GET_END(heap)) {
+            SET_FIELD(heap, next, phys_prev, GET_IDX(heap, new_free));
         }
-        // not found in current segment, let's try in bigger segment
-        seg++;
+        list_push(heap, new_free);
+        // change size only if new chunk is created
+        SET_FIELD(heap, header, size, nb_bytes);
     }
-    return NULL;
+
+    // Update the chunk's header to set the allocated bit
+    SET_FIELD(heap, header, allocated, 0x1);
+
+    // clean-up previous empty header info
+    SET_FIELD(heap, header, fnext, 0);
+    SET_FIELD(heap, header, fprev, 0);
+
+    // Return a pointer to the payload
+    return block + ALLOC_HEADER_SIZE(heap);
+}
+
+/**
+ * @brief allocates a buffer that will never be freed, if possible
+ * @note Permanent buffers are carved downwards from the top of the heap, so that they don't pin
+ * fragments in the area used by @ref mem_alloc. If the chunk just below the permanent region is
+ * not free or too small, the buffer is allocated with @ref mem_alloc instead.
+ *
+ * @param ctx allocator context (returned by @ref mem_init())
+ * @param nb_bytes size in bytes of the buffer to allocate (must be > 0)
+ * @return either a valid address if successful, or NULL if failed (no more memory or invalid
+ * nb_bytes)
+ */
+void *mem_alloc_permanent(mem_ctx_t ctx, size_t nb_bytes)
+{
+    heap_t   *heap   = (heap_t *) ctx;
+    header_t *lowest = NULL;
+    header_t *top    = NULL;
+    size_t    block_size;
+
+    // nb_bytes must be > 0, and not overflow the header size
+    if ((nb_bytes == 0) || (nb_bytes > MAX_ALLOC_SIZE(heap))) {
+        return NULL;
+    }
+    block_size = align_alloc_size(heap, nb_bytes);
+
+    // get the physical chunk just below the permanent region
+    if (heap->permanent_idx != 0) {
+        lowest = GET_PTR(heap, heap->permanent_idx);
+        if (GET_FIELD(heap, lowest, phys_prev) != 0) {
+            top = GET_PTR(heap, GET_FIELD(heap, lowest, phys_prev));
+        }
+    }
+    else {
+        // the region is empty, so it is the last chunk of the heap
+        top = (header_t *) (((uint8_t *) heap) + HEAP_HEADER_SIZE);
+        while ((((uint8_t *) top) + GET_FIELD(heap, top, size)) < (uint8_t *) GET_END(heap)) {
+            top = (header_t *) (((uint8_t *) top) + GET_FIELD(heap, top, size));
+        }
+    }
+    if (top != NULL) {
+        ensure_chunk_valid(heap, top);
+    }
+    if ((top == NULL) || GET_FIELD(heap, top, allocated)
+        || (GET_FIELD(heap, top, size) < block_size)) {
+        return mem_alloc(ctx, nb_bytes);
+    }
+
+    int seg_index = seglist_index(heap, GET_FIELD(heap, top, size));
+    if (seg_index >= 0) {
+        list_remove(heap, seg_index, GET_IDX(heap, top));
+    }
+    header_t *header = top;
+    // keep the beginning of the chunk free, if big enough for a free chunk
+    if (GET_FIELD(heap, top, size) >= (block_size + FREE_HEADER_SIZE(heap))) {
+        SET_FIELD(heap, top, size, GET_FIELD(heap, top, size) - block_size);
+        list_push(heap, top);
+        header = (header_t *) (((uint8_t *) top) + GET_FIELD(heap, top, size));
+        SET_FIELD(heap, header, size, block_size);
+        SET_FIELD(heap, header, phys_prev, GET_IDX(heap, top));
+        if (lowest != NULL) {
+            SET_FIELD(heap, lowest, phys_prev, GET_IDX(heap, header));
+        }
+    }
+    SET_FIELD(heap, header, allocated, 0x1);
+    SET_FIELD(heap, header, fnext, 0);
+    SET_FIELD(heap, header, fprev, 0);
+    // this chunk is now the boundary of the permanent region
+    heap->permanent_idx = GET_IDX(heap, header);
+
+    return ((uint8_t *) header) + ALLOC_HEADER_SIZE(heap);
 }
 
 /**
@@ -449,6 +743,9 @@ void *mem_alloc(mem_ctx_t ctx, size_t nb_bytes)
  * The content is preserved up to the minimum of the old and new sizes.
  * If ptr is NULL, this function behaves like @ref mem_alloc.
  * If size is 0, this function behaves like @ref mem_free and returns NULL.
+ * A growing buffer is extended into the next chunk if it is free (without moving the content),
+ * or else into the previous one (the content is moved once). It is only copied to a new buffer
+ * if none of its neighbours is big enough.
  *
  * @param ctx allocator context (returned by @ref mem_init())
  * @param ptr buffer previously allocated with @ref mem_alloc
@@ -465,10 +762,15 @@ void *mem_realloc(mem_ctx_t ctx, void *ptr, size_t size)
     }
 
     // Check ptr is valid
-    if (ptr < (void *) (((uint8_t *) heap) + HEAP_HEADER_SIZE) || ptr >= (void *) heap->end) {
+    if (ptr < (void *) (((uint8_t *) heap) + HEAP_HEADER_SIZE) || ptr >= GET_END(heap)) {
         PRINTF("invalid pointer passed to realloc: 0x%p!\n", ptr);
         return NULL;
     }
+    // Permanent buffers can be neither resized nor freed
+    if ((heap->permanent_idx != 0) && (ptr > (void *) GET_PTR(heap, heap->permanent_idx))) {
+        PRINTF("permanent buffer passed to realloc: 0x%p!\n", ptr);
+        return NULL;
+    }
 
     // Free the original block if new size is zero
     if (size == 0) {
@@ -477,53 +779,82 @@ void *mem_realloc(mem_ctx_t ctx, void *ptr, size_t size)
     }
 
     // Reject sizes that would overflow the unsigned arithmetic in
-    // align_alloc_size (which adds up to PAYLOAD_ALIGNEMENT - 1 +
-    // ALLOC_CHUNK_HEADER_SIZE + PAYLOAD_ALIGNEMENT bytes of overhead).
-    if (size > MAX_BLOCK_SIZE
-                   - (PAYLOAD_ALIGNEMENT - 1 + ALLOC_CHUNK_HEADER_SIZE + PAYLOAD_ALIGNEMENT)) {
+    // align_alloc_size (which adds up to PAYLOAD_DATA_ALIGNEMENT - 1 +
+    // the header size bytes of overhead).
+    if (size > MAX_ALLOC_SIZE(heap)) {
         return NULL;
     }
 
     // Get the header of the current block
-    uint8_t  *block  = ((uint8_t *) ptr) - ALLOC_CHUNK_HEADER_SIZE;
+    uint8_t  *block  = ((uint8_t *) ptr) - ALLOC_HEADER_SIZE(heap);
     header_t *header = (header_t *) block;
 
     // Ensure this is a valid chunk before we try to read its size.
     ensure_chunk_valid(heap, header);
 
     // Save the size of the old block
-    size_t old_block_size = header->size;
+    size_t old_block_size = GET_FIELD(heap, header, size);
     // Save the size of the data portion of the old block
-    size_t old_payload_size = old_block_size - ALLOC_CHUNK_HEADER_SIZE;
+    size_t old_payload_size = old_block_size - ALLOC_HEADER_SIZE(heap);
     // Adjust size of the new block to include header and satisfy alignment requirements, etc.
-    size_t new_block_size = align_alloc_size(size);
+    size_t new_block_size = align_alloc_size(heap, size);
 
     // If the old block is already big enough, return the same pointer
     if (old_payload_size >= size) {
         // Shrink optimization : split the original block in two
         // if remaining size is enough for a free chunk
-        size_t remainder = old_block_size - new_block_size;
-        if (remainder >= FREE_CHUNK_HEADER_SIZE) {
-            // Save pointer to next physical chunk
-            header_t *next = (header_t *) &block[old_block_size];
-            // Create new free chunk in the remaining space,
-            // located just after the resized block
-            header_t *new_free = (header_t *) &block[new_block_size];
-            new_free->size     = remainder;
-            // The new chunk predecessor is the resized chunk (still the same)
-            new_free->phys_prev = GET_IDX(heap, header);
-            // Link the current next physical chunk to this new chunk (if existing)
-            if ((void *) next < heap->end) {
-                next->phys_prev = GET_IDX(heap, new_free);
-            }
-            list_push(heap, new_free);
-            // Adjust the size of the allocated block
-            header->size = new_block_size;
-        }
+        split_chunk(heap, header, new_block_size);
         // Return the original block pointer as it is still valid
         return ptr;
     }
 
+    // Size of the next physical chunk, if free
+    header_t *next      = (header_t *) &block[old_block_size];
+    size_t    next_size = 0;
+    if ((void *) next < GET_END(heap)) {
+        ensure_chunk_valid(heap, next);
+        if (!GET_FIELD(heap, next, allocated)) {
+            next_size = GET_FIELD(heap, next, size);
+        }
+    }
+
+    // Grow in place, without moving the data, by absorbing the next chunk
+    if ((old_block_size + next_size) >= new_block_size) {
+        coalesce(heap, header, next);
+        split_chunk(heap, header, new_block_size);
+        return ptr;
+    }
+
+    // Grow by also absorbing the previous physical chunk, moving the data once
+    if (GET_FIELD(heap, header, phys_prev) != 0) {
+        chunk_idx_t prev_idx = GET_FIELD(heap, header, phys_prev);
+        header_t   *prev     = GET_PTR(heap, prev_idx);
+        ensure_chunk_valid(heap, prev);
+        if (!GET_FIELD(heap, prev, allocated)
+            && ((GET_FIELD(heap, prev, size) + old_block_size + next_size) >= new_block_size)) {
+            if (next_size != 0) {
+                coalesce(heap, header, next);
+            }
+            // coalesce() can't be used, it would clear the beginning of the data
+            int seg_index = seglist_index(heap, GET_FIELD(heap, prev, size));
+            if (seg_index >= 0) {
+                list_remove(heap, seg_index, prev_idx);
+            }
+            SET_FIELD(
+                heap, prev, size, GET_FIELD(heap, prev, size) + GET_FIELD(heap, header, size));
+            next = (header_t *) (((uint8_t *) prev) + GET_FIELD(heap, prev, size));
+            if ((void *) next < GET_END(heap)) {
+                SET_FIELD(heap, next, phys_prev, prev_idx);
+            }
+            SET_FIELD(heap, prev, allocated, 0x1);
+            SET_FIELD(heap, prev, fnext, 0);
+            SET_FIELD(heap, prev, fprev, 0);
+            memmove(((uint8_t *) prev) + ALLOC_HEADER_SIZE(heap), ptr, old_payload_size);
+            split_chunk(heap, prev, new_block_size);
+            return ((uint8_t *) prev) + ALLOC_HEADER_SIZE(heap);
+        }
+    }
+
     // Allocate new block
     void *new_ptr = mem_alloc(ctx, size);
     if (new_ptr == NULL) {
@@ -551,23 +882,28 @@ void *mem_realloc(mem_ctx_t ctx, void *ptr, size_t size)
 void mem_free(mem_ctx_t ctx, void *ptr)
 {
     heap_t   *heap   = (heap_t *) ctx;
-    uint8_t  *block  = ((uint8_t *) ptr) - ALLOC_CHUNK_HEADER_SIZE;
+    uint8_t  *block  = ((uint8_t *) ptr) - ALLOC_HEADER_SIZE(heap);
     header_t *header = (header_t *) block;
 
     // ensure size is consistent
     ensure_chunk_valid(heap, header);
     // if not allocated, return
-    if (!header->allocated) {
+    if (!GET_FIELD(heap, header, allocated)) {
+        return;
+    }
+    // permanent buffers are never freed
+    if ((heap->permanent_idx != 0) && (header >= GET_PTR(heap, heap->permanent_idx))) {
+        PRINTF("permanent buffer can't be freed: 0x%p!\n", ptr);
         return;
     }
     // try to coalesce with adjacent physical chunks (after and before)
     // try with next physical chunk
-    if ((block + header->size) < (uint8_t *) heap->end) {
-        header = coalesce(heap, header, (header_t *) (block + header->size));
+    if ((block + GET_FIELD(heap, header, size)) < (uint8_t *) GET_END(heap)) {
+        header = coalesce(heap, header, (header_t *) (block + GET_FIELD(heap, header, size)));
     }
     // try previous chunk
-    if (header->phys_prev != 0) {
-        header = coalesce(heap, header, GET_PTR(heap, header->phys_prev));
+    if (GET_FIELD(heap, header, phys_prev) != 0) {
+        header = coalesce(heap, header, GET_PTR(heap, GET_FIELD(heap, header, phys_prev)));
     }
 
     // free chunk and add it on top of free chunk LIFO
@@ -601,12 +937,13 @@ void mem_parse(mem_ctx_t ctx, mem_parse_callback_t callback, void *data)
 #endif  // DEBUG_FREE_SEGMENTS
     while (header != NULL) {
         uint8_t *block = (uint8_t *) header;
+        size_t   size  = GET_FIELD(heap, header, size);
         // break the loop if the callback returns true
-        if (callback(data, block, header->allocated, header->size)) {
+        if (callback(data, block, GET_FIELD(heap, header, allocated), size)) {
             return;
         }
-        if (&block[header->size] < (uint8_t *) heap->end) {
-            header = (header_t *) &block[header->size];
+        if (&block[size] < (uint8_t *) GET_END(heap)) {
+            header = (header_t *) &block[size];
         }
         else {
             return;
@@ -625,7 +962,207 @@ void mem_parse(mem_ctx_t ctx, mem_parse_callback_t callback, void *data)
  */
 void mem_stat(mem_ctx_t *ctx, mem_stat_t *stat)
 {
+    heap_t *heap = (heap_t *) ctx;
+
     memset(stat, 0, sizeof(mem_stat_t));
     stat->total_size = HEAP_HEADER_SIZE;
     mem_parse(ctx, parse_callback, stat);
+    if (heap->permanent_idx != 0) {
+        stat->permanent_size = heap->size - (heap->permanent_idx << 3);
+    }
+    stat->transient_size = stat->total_size - HEAP_HEADER_SIZE - stat->permanent_size;
+}
+
+/**
+ * @brief allocates the table of the handles used by @ref mem_handle_alloc
+ * @note The table is a permanent buffer: it is allocated once, and never moved by
+ * @ref mem_compact
+ *
+ * @param ctx allocator context (returned by @ref mem_init())
+ * @param nb_handles max number of relocatable buffers allocated at the same time (must be > 0)
+ * @return true if successful, false otherwise (no more memory, invalid nb_handles or table
+ * already allocated)
+ */
+bool mem_handles_init(mem_ctx_t ctx, uint8_t nb_handles)
+{
+    heap_t *heap = (heap_t *) ctx;
+    void   *table;
+
+    if ((nb_handles == 0) || (heap->handles_idx != 0)) {
+        return false;
+    }
+    table = mem_alloc_permanent(ctx, nb_handles * sizeof(handle_entry_t));
+    if (table == NULL) {
+        return false;
+    }
+    memset(table, 0, nb_handles * sizeof(handle_entry_t));
+    heap->handles_idx = GET_IDX(heap, ((uint8_t *) table) - ALLOC_HEADER_SIZE(heap));
+    heap->nb_handles  = nb_handles;
+    return true;
+}
+
+/**
+ * @brief allocates a relocatable buffer of the given size, if possible
+ * @note The address of the buffer is given by @ref mem_handle_lock, and is only valid until
+ * @ref mem_handle_unlock, because @ref mem_compact may move the unlocked buffers. This buffer
+ * should be freed later with @ref mem_handle_free (and not with @ref mem_free)
+ *
+ * @param ctx allocator context (returned by @ref mem_init())
+ * @param nb_bytes size in bytes of the buffer to allocate (must be > 0)
+ * @return either a valid handle if successful, or @ref MEM_INVALID_HANDLE if failed (no more
+ * memory or handles, invalid nb_bytes, or table not allocated by @ref mem_handles_init)
+ */
+mem_handle_t mem_handle_alloc(mem_ctx_t ctx, size_t nb_bytes)
+{
+    heap_t         *heap = (heap_t *) ctx;
+    handle_entry_t *entries;
+    uint8_t        *ptr;
+
+    if (heap->handles_idx == 0) {
+        return MEM_INVALID_HANDLE;
+    }
+    entries = (handle_entry_t *) (((uint8_t *) GET_PTR(heap, heap->handles_idx))
+                                  + ALLOC_HEADER_SIZE(heap));
+    for (mem_handle_t handle = 1; handle <= heap->nb_handles; handle++) {
+        if (entries[handle - 1].chunk_idx == 0) {
+            ptr = mem_alloc(ctx, nb_bytes);
+            if (ptr == NULL) {
+                return MEM_INVALID_HANDLE;
+            }
+            entries[handle - 1].chunk_idx = GET_IDX(heap, ptr - ALLOC_HEADER_SIZE(heap));
+            entries[handle - 1].nb_locks  = 0;
+            return handle;
+        }
+    }
+    return MEM_INVALID_HANDLE;
+}
+
+/**
+ * @brief locks the given relocatable buffer, to get its address
+ * @note Locks are counted: the buffer can be moved again once unlocked as many times
+ *
+ * @param ctx allocator context (returned by @ref mem_init())
+ * @param handle handle returned by @ref mem_handle_alloc
+ * @return address of the buffer, or NULL if the handle is invalid
+ */
+void *mem_handle_lock(mem_ctx_t ctx, mem_handle_t handle)
+{
+    heap_t         *heap  = (heap_t *) ctx;
+    handle_entry_t *entry = get_handle_entry(heap, handle);
+
+    if ((entry == NULL) || (entry->nb_locks == UINT8_MAX)) {
+        return NULL;
+    }
+    entry->nb_locks++;
+    return ((uint8_t *) GET_PTR(heap, entry->chunk_idx)) + ALLOC_HEADER_SIZE(heap);
+}
+
+/**
+ * @brief unlocks the given relocatable buffer
+ * @note The address returned by @ref mem_handle_lock must not be used anymore
+ *
+ * @param ctx allocator context (returned by @ref mem_init())
+ * @param handle handle returned by @ref mem_handle_alloc
+ */
+void mem_handle_unlock(mem_ctx_t ctx, mem_handle_t handle)
+{
+    handle_entry_t *entry = get_handle_entry((heap_t *) ctx, handle);
+
+    if ((entry != NULL) && (entry->nb_locks > 0)) {
+        entry->nb_locks--;
+    }
+}
+
+/**
+ * @brief frees the given relocatable buffer, even if locked, and its handle
+ *
+ * @param ctx allocator context (returned by @ref mem_init())
+ * @param handle handle returned by @ref mem_handle_alloc
+ */
+void mem_handle_free(mem_ctx_t ctx, mem_handle_t handle)
+{
+    heap_t         *heap  = (heap_t *) ctx;
+    handle_entry_t *entry = get_handle_entry(heap, handle);
+
+    if (entry == NULL) {
+        return;
+    }
+    mem_free(ctx, ((uint8_t *) GET_PTR(heap, entry->chunk_idx)) + ALLOC_HEADER_SIZE(heap));
+    entry->chunk_idx = 0;
+    entry->nb_locks  = 0;
+}
+
+/**
+ * @brief compacts the heap, by sliding the unlocked relocatable buffers down to the free chunks
+ * below them
+ * @note The buffers allocated with @ref mem_alloc, the locked relocatable buffers and the
+ * permanent buffers are not moved: the free chunks just below them are merged, but not filled.
+ * The handle table is updated with the new location of the moved buffers.
+ *
+ * @param ctx allocator context (returned by @ref mem_init())
+ * @return size in bytes of the biggest free chunk (header excluded)
+ */
+size_t mem_compact(mem_ctx_t ctx)
+{
+    heap_t     *heap     = (heap_t *) ctx;
+    header_t   *header   = (header_t *) (((uint8_t *) heap) + HEAP_HEADER_SIZE);
+    header_t   *gap      = NULL;  // beginning of the free area below the current chunk, if any
+    chunk_idx_t prev_idx = 0;     // last chunk below the free area
+    size_t      biggest  = 0;
+    void       *limit;
+
+    // permanent buffers are never moved, so the chunks above them don't need to be parsed
+    limit = (heap->permanent_idx != 0) ? (void *) GET_PTR(heap, heap->permanent_idx)
+                                       : GET_END(heap);
+    while ((void *) header < limit) {
+        if (gap != NULL) {
+            // the previous chunk may have been moved, so the link to it can't be checked (it is
+            // rewritten anyway)
+            SET_FIELD(heap, header, phys_prev, 0);
+        }
+        ensure_chunk_valid(heap, header);
+        header_t       *next  = (header_t *) (((uint8_t *) header) + GET_FIELD(heap, header, size));
+        handle_entry_t *entry = NULL;
+
+        if (!GET_FIELD(heap, header, allocated)) {
+            // the free chunk is merged in the free area, which is pushed again once closed
+            int seg_index = seglist_index(heap, GET_FIELD(heap, header, size));
+            if (seg_index >= 0) {
+                list_remove(heap, seg_index, GET_IDX(heap, header));
+            }
+            if (gap == NULL) {
+                gap = header;
+            }
+        }
+        else {
+            // only the unlocked relocatable buffers can be moved
+            if (gap != NULL) {
+                entry = find_handle_entry(heap, GET_IDX(heap, header));
+            }
+            if ((entry != NULL) && (entry->nb_locks == 0)) {
+                // slide the chunk to the beginning of the free area (both may overlap)
+                memmove(gap, header, GET_FIELD(heap, header, size));
+                SET_FIELD(heap, gap, phys_prev, prev_idx);
+                prev_idx         = GET_IDX(heap, gap);
+                entry->chunk_idx = prev_idx;
+                gap              = (header_t *) (((uint8_t *) gap) + GET_FIELD(heap, gap, size));
+            }
+            else {
+                // the free area below this chunk is complete
+                if (gap != NULL) {
+                    close_gap(heap, gap, prev_idx, header);
+                    biggest = MAX(biggest, GET_FIELD(heap, gap, size));
+                    gap     = NULL;
+                }
+                prev_idx = GET_IDX(heap, header);
+            }
+        }
+        header = next;
+    }
+    if (gap != NULL) {
+        close_gap(heap, gap, prev_idx, limit);
+        biggest = MAX(biggest, GET_FIELD(heap, gap, size));
+    }
+
+    return (biggest != 0) ? (biggest - ALLOC_HEADER_SIZE(heap)) : 0;
 }
@@ -17,6 +17,12 @@ extern "C" {
 #include <stdbool.h>
 #include <stddef.h>
 
+/*********************
+ *      DEFINES
+ *********************/
+// Handle returned by @ref mem_handle_alloc on failure
+#define MEM_INVALID_HANDLE 0
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -50,19 +56,35 @@ typedef struct {
     size_t   allocated_size;  ///< nb bytes allocated in the heap (including headers)
     uint32_t nb_chunks;       ///< total number of chunks
     uint32_t nb_allocated;    ///< number of allocated chunks
+    size_t   transient_size;  ///< size of the area used by @ref mem_alloc (free and allocated)
+    size_t   permanent_size;  ///< size of the area used by @ref mem_alloc_permanent, at the top
 } mem_stat_t;
 
+/**
+ * @brief handle of a relocatable buffer, allocated by @ref mem_handle_alloc
+ *
+ */
+typedef uint16_t mem_handle_t;
+
 /**********************
  *      GLOBAL PROTOTYPES
  **********************/
 
 mem_ctx_t mem_init(void *heap_start, size_t heap_size);
 void     *mem_alloc(mem_ctx_t ctx, size_t nb_bytes);
+void     *mem_alloc_permanent(mem_ctx_t ctx, size_t nb_bytes);
 void     *mem_realloc(mem_ctx_t ctx, void *ptr, size_t size);
 void      mem_free(mem_ctx_t ctx, void *ptr);
 void      mem_parse(mem_ctx_t ctx, mem_parse_callback_t callback, void *dat);
 void      mem_stat(mem_ctx_t *ctx, mem_stat_t *stat);
 
+bool         mem_handles_init(mem_ctx_t ctx, uint8_t nb_handles);
+mem_handle_t mem_handle_alloc(mem_ctx_t ctx, size_t nb_bytes);
+void        *mem_handle_lock(mem_ctx_t ctx, mem_handle_t handle);
+void         mem_handle_unlock(mem_ctx_t ctx, mem_handle_t handle);
+void         mem_handle_free(mem_ctx_t ctx, mem_handle_t handle);
+size_t       mem_compact(mem_ctx_t ctx);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -0,0 +1,97 @@
+/**
+ * @file mem_arena.c
+ * @brief Scoped arena allocator implementation
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "mem_arena.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+// Alignment of the returned buffers, as needed by 64-bit types
+#define ARENA_ALIGNEMENT 8
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * @brief allocates the backing buffer of an arena
+ * @note The buffers allocated in the arena have no header: they can't be freed one by one, but
+ * are all released at once by @ref mem_arena_reset or @ref mem_arena_end
+ *
+ * @param ctx allocator context (returned by @ref mem_init())
+ * @param arena arena to initialize
+ * @param size size in bytes of the backing buffer (must be > 0)
+ * @return true if successful, false otherwise (no more memory or invalid size)
+ */
+bool mem_arena_begin(mem_ctx_t ctx, mem_arena_t *arena, size_t size)
+{
+    memset(arena, 0, sizeof(mem_arena_t));
+    arena->buffer = mem_alloc(ctx, size);
+    if (arena->buffer == NULL) {
+        return false;
+    }
+    arena->size = size;
+    return true;
+}
+
+/**
+ * @brief allocates a buffer in the given arena, if possible
+ * @note The returned buffers are aligned on 8 bytes. As the backing buffer, like any buffer
+ * returned by @ref mem_alloc, may only be aligned on 4 bytes, up to 4 bytes of it may be lost.
+ *
+ * @param arena arena initialized with @ref mem_arena_begin
+ * @param nb_bytes size in bytes of the buffer to allocate (must be > 0)
+ * @return either a valid address if successful, or NULL if failed (arena full or invalid
+ * nb_bytes)
+ */
+void *mem_arena_alloc(mem_arena_t *arena, size_t nb_bytes)
+{
+    size_t offset;
+
+    if ((arena->buffer == NULL) || (nb_bytes == 0)) {
+        return NULL;
+    }
+    // align the address of the buffer, not only its offset in the backing buffer
+    offset = arena->offset
+             + ((ARENA_ALIGNEMENT - ((uintptr_t) &arena->buffer[arena->offset]))
+                & (ARENA_ALIGNEMENT - 1));
+    if ((offset > arena->size) || (nb_bytes > (arena->size - offset))) {
+        return NULL;
+    }
+    arena->offset = offset + nb_bytes;
+    if (arena->offset > arena->high_water) {
+        arena->high_water = arena->offset;
+    }
+    return &arena->buffer[offset];
+}
+
+/**
+ * @brief releases all the buffers allocated in the given arena
+ * @note The backing buffer is kept, for the next allocations
+ *
+ * @param arena arena initialized with @ref mem_arena_begin
+ */
+void mem_arena_reset(mem_arena_t *arena)
+{
+    arena->offset = 0;
+}
+
+/**
+ * @brief releases all the buffers allocated in the given arena, and its backing buffer
+ *
+ * @param ctx allocator context (returned by @ref mem_init())
+ * @param arena arena initialized with @ref mem_arena_begin
+ */
+void mem_arena_end(mem_ctx_t ctx, mem_arena_t *arena)
+{
+    if (arena->buffer != NULL) {
+        mem_free(ctx, arena->buffer);
+    }
+    memset(arena, 0, sizeof(mem_arena_t));
+}
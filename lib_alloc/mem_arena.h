@@ -0,0 +1,46 @@
+/**
+ * @file mem_arena.h
+ * @brief Scoped arena allocator, on top of the dynamic memory allocator
+ *
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "mem_alloc.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/**
+ * @brief arena context, filled by @ref mem_arena_begin
+ *
+ */
+typedef struct {
+    uint8_t *buffer;      ///< backing buffer, allocated with @ref mem_alloc
+    size_t   size;        ///< size of the backing buffer, in bytes
+    size_t   offset;      ///< nb bytes currently allocated in the backing buffer
+    size_t   high_water;  ///< max value reached by offset since @ref mem_arena_begin
+} mem_arena_t;
+
+/**********************
+ *      GLOBAL PROTOTYPES
+ **********************/
+
+bool  mem_arena_begin(mem_ctx_t ctx, mem_arena_t *arena, size_t size);
+void *mem_arena_alloc(mem_arena_t *arena, size_t nb_bytes);
+void  mem_arena_reset(mem_arena_t *arena);
+void  mem_arena_end(mem_ctx_t ctx, mem_arena_t *arena);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
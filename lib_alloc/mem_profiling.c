@@ -0,0 +1,176 @@
+/**
+ * @file mem_profiling.c
+ * @brief Binary ring buffer of the memory profiling events
+ *
+ * Each event costs a few stores, instead of formatting a PRINTF line. The ring buffer is read
+ * with @ref mem_profiling_dump, as a stream made of:
+ * - a header: "MP", format version, nb call-sites, ring size (U2BE), nb events in the dump (U2BE),
+ *   total nb of logged events (U4BE) and flags (@ref DUMP_FLAG_WIDE_HEADERS)
+ * - the call-sites: line (U2BE), length of the file name, file name
+ * - the events, from the oldest: op, call-site, address (U4BE), size (U4BE)
+ *
+ * tools/memprof.py decodes this stream.
+ */
+
+#ifdef HAVE_MEMORY_PROFILING_RING
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "os_math.h"
+#include "os_utils.h"
+#include "mem_profiling.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DUMP_FORMAT_VERSION 2
+
+// The allocator is built with HAVE_MEM_ALLOC_WIDE_HEADER: its heap header is bigger, and the heaps
+// bigger than 32 kBytes use wide chunk headers
+#define DUMP_FLAG_WIDE_HEADERS 0x01
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    const char *file;
+    uint16_t    line;
+} site_t;
+
+typedef struct {
+    uint32_t              nb_events;  ///< total number of logged events
+    uint8_t               nb_sites;
+    site_t                sites[MEM_PROFILING_NB_SITES];
+    mem_profiling_event_t events[MEM_PROFILING_NB_EVENTS];
+} mem_profiling_t;
+
+// context of the stream written by mem_profiling_dump
+typedef struct {
+    size_t   pos;     ///< position in the stream
+    size_t   offset;  ///< position of the first byte to copy
+    uint8_t *buffer;
+    size_t   buffer_size;
+    size_t   length;  ///< nb bytes copied in buffer
+} dump_ctx_t;
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static mem_profiling_t mem_profiling;
+
+/**********************
+ *   LOCAL FUNCTIONS
+ **********************/
+static uint8_t get_site(const char *file, int line)
+{
+    uint8_t site;
+
+    for (site = 0; site < mem_profiling.nb_sites; site++) {
+        if ((mem_profiling.sites[site].file == file) && (mem_profiling.sites[site].line == line)) {
+            return site;
+        }
+    }
+    if (site == MEM_PROFILING_NB_SITES) {
+        return MEM_PROFILING_UNKNOWN_SITE;
+    }
+    mem_profiling.sites[site].file = file;
+    mem_profiling.sites[site].line = line;
+    mem_profiling.nb_sites++;
+    return site;
+}
+
+// copies the part of the given data overlapping the requested window of the stream
+static void dump_write(dump_ctx_t *ctx, const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++, ctx->pos++) {
+        if ((ctx->pos >= ctx->offset) && (ctx->length < ctx->buffer_size)) {
+            ctx->buffer[ctx->length++] = data[i];
+        }
+    }
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * @brief records an event in the ring buffer
+ *
+ * @param op operation
+ * @param addr address of the buffer (or of the heap for @ref MEM_PROFILING_OP_INIT)
+ * @param size size of the buffer (see @ref mem_profiling_op_t)
+ * @param file source file of the call-site (may be NULL)
+ * @param line line in the source file of the call-site
+ */
+void mem_profiling_log(mem_profiling_op_t op,
+                       const void        *addr,
+                       size_t             size,
+                       const char        *file,
+                       int                line)
+{
+    mem_profiling_event_t *event
+        = &mem_profiling.events[mem_profiling.nb_events % MEM_PROFILING_NB_EVENTS];
+
+    event->op   = op;
+    event->site = get_site(file, line);
+    event->addr = (uint32_t) (uintptr_t) addr;
+    event->size = size;
+    mem_profiling.nb_events++;
+}
+
+/**
+ * @brief reads a part of the dump of the ring buffer
+ * @note The whole dump is read by calling this function with increasing offsets, until it
+ * returns less than buffer_size bytes.
+ *
+ * @param offset position in the dump of the first byte to read
+ * @param buffer output buffer
+ * @param buffer_size size of buffer
+ * @return nb bytes written in buffer
+ */
+size_t mem_profiling_dump(size_t offset, uint8_t *buffer, size_t buffer_size)
+{
+    dump_ctx_t ctx        = {.offset = offset, .buffer = buffer, .buffer_size = buffer_size};
+    uint32_t   nb_events  = MIN(mem_profiling.nb_events, MEM_PROFILING_NB_EVENTS);
+    uint8_t    header[13] = {'M', 'P', DUMP_FORMAT_VERSION, mem_profiling.nb_sites};
+    uint8_t    data[10];
+
+    U2BE_ENCODE(header, 4, MEM_PROFILING_NB_EVENTS);
+    U2BE_ENCODE(header, 6, nb_events);
+    U4BE_ENCODE(header, 8, mem_profiling.nb_events);
+#ifdef HAVE_MEM_ALLOC_WIDE_HEADER
+    header[12] = DUMP_FLAG_WIDE_HEADERS;
+#endif  // HAVE_MEM_ALLOC_WIDE_HEADER
+    dump_write(&ctx, header, sizeof(header));
+
+    for (uint8_t site = 0; site < mem_profiling.nb_sites; site++) {
+        const char *file   = mem_profiling.sites[site].file;
+        size_t      length = (file != NULL) ? strlen(file) : 0;
+
+        // keep the end of the path, which is the most meaningful part
+        if (length > MEM_PROFILING_FILE_NAME_LEN) {
+            file += length - MEM_PROFILING_FILE_NAME_LEN;
+            length = MEM_PROFILING_FILE_NAME_LEN;
+        }
+        U2BE_ENCODE(data, 0, mem_profiling.sites[site].line);
+        data[2] = length;
+        dump_write(&ctx, data, 3);
+        dump_write(&ctx, (const uint8_t *) file, length);
+    }
+
+    for (uint32_t i = mem_profiling.nb_events - nb_events; i < mem_profiling.nb_events; i++) {
+        const mem_profiling_event_t *event = &mem_profiling.events[i % MEM_PROFILING_NB_EVENTS];
+
+        data[0] = event->op;
+        data[1] = event->site;
+        U4BE_ENCODE(data, 2, event->addr);
+        U4BE_ENCODE(data, 6, event->size);
+        dump_write(&ctx, data, sizeof(data));
+    }
+
+    return ctx.length;
+}
+
+#endif  // HAVE_MEMORY_PROFILING_RING
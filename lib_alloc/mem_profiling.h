@@ -0,0 +1,84 @@
+/**
+ * @file mem_profiling.h
+ * @brief Binary ring buffer of the memory profiling events
+ *
+ */
+
+#pragma once
+
+#ifdef HAVE_MEMORY_PROFILING_RING
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stddef.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+// Number of events kept in the ring buffer (the oldest ones are overwritten)
+#ifndef MEM_PROFILING_NB_EVENTS
+#define MEM_PROFILING_NB_EVENTS 128
+#endif  // MEM_PROFILING_NB_EVENTS
+
+// Max number of distinct call-sites (file and line) recorded
+#ifndef MEM_PROFILING_NB_SITES
+#define MEM_PROFILING_NB_SITES 32
+#endif  // MEM_PROFILING_NB_SITES
+
+// Call-site of the events logged once the call-site table is full
+#define MEM_PROFILING_UNKNOWN_SITE 0xFF
+
+// Max length of the file names in the dump (only the end of longer names is kept)
+#define MEM_PROFILING_FILE_NAME_LEN 32
+
+// Max length of the parts of the dump read by the default APDU
+#define MEM_PROFILING_DUMP_CHUNK_SIZE 250
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/**
+ * @brief operations recorded in the ring buffer
+ *
+ */
+typedef enum {
+    MEM_PROFILING_OP_INIT,     ///< heap (re)initialization: address and size of the heap
+    MEM_PROFILING_OP_ALLOC,    ///< allocation: address and requested size
+    MEM_PROFILING_OP_PERSIST,  ///< permanent allocation: address and requested size
+    MEM_PROFILING_OP_FREE,     ///< free: address
+    MEM_PROFILING_OP_ARENA,    ///< arena reset or end: address and high-water mark
+} mem_profiling_op_t;
+
+/**
+ * @brief event stored in the ring buffer
+ *
+ */
+typedef struct {
+    uint8_t  op;    ///< @ref mem_profiling_op_t
+    uint8_t  site;  ///< index in the call-site table, or @ref MEM_PROFILING_UNKNOWN_SITE
+    uint32_t addr;  ///< address of the buffer
+    uint32_t size;  ///< size, depending on op
+} mem_profiling_event_t;
+
+/**********************
+ *      GLOBAL PROTOTYPES
+ **********************/
+
+void   mem_profiling_log(mem_profiling_op_t op,
+                         const void        *addr,
+                         size_t             size,
+                         const char        *file,
+                         int                line);
+size_t mem_profiling_dump(size_t offset, uint8_t *buffer, size_t buffer_size);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // HAVE_MEMORY_PROFILING_RING
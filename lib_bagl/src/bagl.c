@@ -94,8 +94,23 @@ unsigned int                    G_glyph_count;
 #endif  // HAVE_BAGL_GLYPH_ARRAY
 
 #if defined(HAVE_UNICODE_SUPPORT)
+// number of recently used Unicode characters kept in cache
+#define UNICODE_CACHE_SIZE 4
+
+typedef struct {
+    const bagl_font_unicode_character_t *characters;  // array in which the character was found
+    unsigned int                         unicode;
+    unsigned int                         index;  // index of the character in this array
+    bool                                 valid;
+#if defined(HAVE_LANGUAGE_PACK)
+    const void *language_pack;  // language pack in which the character was found
+#endif  // defined(HAVE_LANGUAGE_PACK)
+} unicode_cache_entry_t;
+
 static const bagl_font_unicode_t *font_unicode;
 static unsigned int               unicode_byte_count;
+static unicode_cache_entry_t      unicode_cache[UNICODE_CACHE_SIZE];
+static unsigned int               unicode_cache_next;
 #endif  // defined(HAVE_UNICODE_SUPPORT)
 
 #if defined(HAVE_LANGUAGE_PACK)
@@ -220,22 +235,70 @@ const bagl_font_unicode_character_t *get_unicode_character(unsigned int unicode)
     const bagl_font_unicode_character_t *characters = PIC_CHARU(font_unicode->characters);
     unsigned int                         n          = C_unicode_characters_count;
 #endif  // defined(HAVE_LANGUAGE_PACK)
-    // For the moment, let just parse the full array, but at the end let use
-    // binary search as data are sorted by unicode value !
-    for (unsigned i = 0; i < n - 1; i++, characters++) {
-        if ((PIC_CHARU(characters))->char_unicode == unicode) {
-            // Compute the number of bytes used to display this character
-            unicode_byte_count = (PIC_CHARU(characters + 1))->bitmap_offset
-                                 - (PIC_CHARU(characters))->bitmap_offset;
-            return (PIC_CHARU(characters));
+    const bagl_font_unicode_character_t *character;
+    unicode_cache_entry_t               *entry;
+    unsigned int                         low = n;
+
+    // The same characters are usually drawn again and again (when measuring then drawing a text,
+    // or in a given language), so first look in the recently used ones. An entry is only used if
+    // it was found in the same language pack and font, and still matches the character there.
+    for (unsigned int i = 0; i < UNICODE_CACHE_SIZE; i++) {
+        entry = &unicode_cache[i];
+        if (entry->valid && entry->characters == characters && entry->unicode == unicode
+#if defined(HAVE_LANGUAGE_PACK)
+            && entry->language_pack == language_pack
+#endif  // defined(HAVE_LANGUAGE_PACK)
+            && entry->index < n
+            && ((entry->index == n - 1)
+                || (PIC_CHARU(characters + entry->index))->char_unicode == unicode)) {
+            low = entry->index;
+            break;
+        }
+    }
+
+    if (low == n) {
+        // The characters are sorted by unicode value, except the last one: binary search among
+        // them
+        low               = 0;
+        unsigned int high = n - 1;
+        while (low < high) {
+            unsigned int middle = (low + high) / 2;
+            if ((PIC_CHARU(characters + middle))->char_unicode < unicode) {
+                low = middle + 1;
+            }
+            else {
+                high = middle;
+            }
+        }
+        if ((PIC_CHARU(characters + low))->char_unicode != unicode) {
+            // By default, let's use the last Unicode character, which should be the
+            // 0x00FFFD one, used to replace unrecognized or unrepresentable character.
+            low = n - 1;
         }
+
+        // Replace the oldest entry of the cache
+        entry = &unicode_cache[unicode_cache_next];
+#if defined(HAVE_LANGUAGE_PACK)
+        entry->language_pack = language_pack;
+#endif  // defined(HAVE_LANGUAGE_PACK)
+        entry->characters  = characters;
+        entry->unicode     = unicode;
+        entry->index       = low;
+        entry->valid       = true;
+        unicode_cache_next = (unicode_cache_next + 1) % UNICODE_CACHE_SIZE;
     }
-    // By default, let's use the last Unicode character, which should be the
-    // 0x00FFFD one, used to replace unrecognized or unrepresentable character.
 
+    character = PIC_CHARU(characters + low);
     // Compute the number of bytes used to display this character
-    unicode_byte_count = font_unicode->bitmap_len - (PIC_CHARU(characters))->bitmap_offset;
-    return (PIC_CHARU(characters));
+    if (low < n - 1) {
+        unicode_byte_count
+            = (PIC_CHARU(characters + low + 1))->bitmap_offset - character->bitmap_offset;
+    }
+    else {
+        unicode_byte_count = font_unicode->bitmap_len - character->bitmap_offset;
+    }
+
+    return character;
 }
 
 // ----------------------------------------------------------------------------
@@ -1257,6 +1320,9 @@ void bagl_init(void)
 
 #if defined(HAVE_UNICODE_SUPPORT)
     font_unicode = NULL;
+    // The language pack may have been changed
+    memset(unicode_cache, 0, sizeof(unicode_cache));
+    unicode_cache_next = 0;
 #endif  // defined(HAVE_UNICODE_SUPPORT)
 }
 
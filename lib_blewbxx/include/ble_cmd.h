@@ -43,6 +43,10 @@ void ble_hci_forge_cmd_disconnect(ble_cmd_data_t *cmd_data, uint16_t connection_
 void ble_hci_forge_cmd_set_scan_response_data(ble_cmd_data_t *cmd_data,
                                               uint8_t         scan_response_data_length,
                                               const uint8_t  *scan_response_data);
+void ble_hci_forge_cmd_set_data_length(ble_cmd_data_t *cmd_data,
+                                       uint16_t        connection_handle,
+                                       uint16_t        tx_octets,
+                                       uint16_t        tx_time);
 
 /* ACI HAL cmd */
 void ble_aci_hal_forge_cmd_write_config_data(ble_cmd_data_t *cmd_data,
@@ -51,7 +51,8 @@ ble_profile_status_t BLE_LEDGER_PROFILE_apdu_write_permit_req(uint8_t *hci_buffe
 ble_profile_status_t BLE_LEDGER_PROFILE_apdu_mtu_changed(uint16_t mtu, void *cookie);
 
 ble_profile_status_t BLE_LEDGER_PROFILE_apdu_write_rsp_ack(void *cookie);
-ble_profile_status_t BLE_LEDGER_PROFILE_apdu_update_char_value_ack(void *cookie);
+ble_profile_status_t BLE_LEDGER_PROFILE_apdu_update_char_value_ack(uint8_t hci_status, void *cookie);
+ble_profile_status_t BLE_LEDGER_PROFILE_apdu_tx_pool_available(void *cookie);
 bool BLE_LEDGER_PROFILE_apdu_is_busy(void *cookie);
 
 ble_profile_status_t BLE_LEDGER_PROFILE_apdu_send_packet(const uint8_t *packet, uint16_t length, void *cookie);
@@ -65,7 +65,8 @@ typedef ble_profile_status_t (*ble_profile_write_permit_req_t)(uint8_t *hci_buff
 typedef ble_profile_status_t (*ble_profile_mtu_changed_t)(uint16_t mtu, void *cookie);
 
 typedef ble_profile_status_t (*ble_profile_write_rsp_ack_t)(void *cookie);
-typedef ble_profile_status_t (*ble_profile_update_char_value_ack_t)(void *cookie);
+typedef ble_profile_status_t (*ble_profile_update_char_value_ack_t)(uint8_t hci_status, void *cookie);
+typedef ble_profile_status_t (*ble_profile_tx_pool_available_t)(void *cookie);
 
 typedef ble_profile_status_t (*ble_profile_send_packet_t)(const uint8_t *packet, uint16_t length, void *cookie);
 typedef bool (*ble_profile_is_busy_t)(void *cookie);
@@ -93,6 +94,7 @@ typedef struct ble_profile_info_t_ {
 
     ble_profile_write_rsp_ack_t         write_rsp_ack;
     ble_profile_update_char_value_ack_t update_char_val_ack;
+    ble_profile_tx_pool_available_t     tx_pool_available;
 
     ble_profile_send_packet_t send_packet;
     ble_profile_is_busy_t     is_busy;
@@ -24,7 +24,8 @@
 
 /* HCI Error codes */
 typedef enum ble_hci_error_codes_e {
-    HCI_SUCCESS_ERR_CODE = 0x00,
+    HCI_SUCCESS_ERR_CODE                = 0x00,
+    BLE_INSUFFICIENT_RESOURCES_ERR_CODE = 0x64,  // Vendor specific, controller TX pool is full
 } ble_hci_error_codes_t;
 
 /* HCI Event codes */
@@ -42,6 +43,7 @@ typedef enum ble_hci_evt_codes_e {
 typedef enum ble_hci_cmd_codes_e {
     HCI_DISCONNECT_CMD_CODE                = 0x0406,
     HCI_LE_SET_SCAN_RESPONSE_DATA_CMD_CODE = 0x2009,
+    HCI_LE_SET_DATA_LENGTH_CMD_CODE        = 0x2022,
     HCI_RESET_CMD_CODE                     = 0x0c03,
 } ble_hci_cmd_codes_t;
 
@@ -80,6 +82,7 @@ typedef enum ble_aci_evt_codes_e {
     ACI_GATT_INDICATION_VSEVT_CODE         = 0x0c0e,
     ACI_GATT_PROC_COMPLETE_VSEVT_CODE      = 0x0c10,
     ACI_GATT_WRITE_PERMIT_REQ_VSEVT_CODE   = 0x0c13,
+    ACI_GATT_TX_POOL_AVAILABLE_VSEVT_CODE  = 0x0c16,
 } ble_aci_evt_codes_t;
 
 /* ACI vendor specific cmd codes */
@@ -212,6 +215,9 @@ typedef struct ble_hci_event_packet_s {
 #define BLE_GAP_USE_FIXED_PIN_FOR_PAIRING_FORBIDDEN 0x01
 #define BLE_GAP_STATIC_RANDOM_ADDR                  0x01
 
+/* LE data length extension */
+#define BLE_LL_MAX_TX_OCTETS 251U
+
 /* GAP ADV/SCAN */
 #define BLE_GAP_MAX_ADV_DATA_LEN      31U
 #define BLE_GAP_MAX_LOCAL_NAME_LENGTH 20U
@@ -222,6 +228,7 @@ typedef struct ble_hci_event_packet_s {
 /* ATT/GATT */
 #define BLE_ATT_DEFAULT_MTU                   23U
 #define BLE_ATT_MAX_MTU_SIZE                  156U
+#define BLE_L2CAP_HEADER_SIZE                 4U
 #define BLE_GATT_UUID_TYPE_128                0x02
 #define BLE_GATT_PRIMARY_SERVICE              0x01
 #define BLE_GATT_MAX_SERVICE_RECORDS          9U
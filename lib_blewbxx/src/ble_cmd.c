@@ -81,6 +81,22 @@ void ble_hci_forge_cmd_set_scan_response_data(ble_cmd_data_t *cmd_data,
         = MIN(BLE_GAP_MAX_ADV_DATA_LEN + 3, sizeof(cmd_data->hci_cmd_buffer));
 }
 
+void ble_hci_forge_cmd_set_data_length(ble_cmd_data_t *cmd_data,
+                                       uint16_t        connection_handle,
+                                       uint16_t        tx_octets,
+                                       uint16_t        tx_time)
+{
+    if (!cmd_data) {
+        return;
+    }
+
+    start_packet_with_opcode(cmd_data, HCI_LE_SET_DATA_LENGTH_CMD_CODE);
+    U2LE_ENCODE(cmd_data->hci_cmd_buffer, 2, connection_handle);
+    U2LE_ENCODE(cmd_data->hci_cmd_buffer, 4, tx_octets);
+    U2LE_ENCODE(cmd_data->hci_cmd_buffer, 6, tx_time);
+    cmd_data->hci_cmd_buffer_length = 8;
+}
+
 void ble_aci_hal_forge_cmd_write_config_data(ble_cmd_data_t *cmd_data,
                                              uint8_t         offset,
                                              uint8_t         length,
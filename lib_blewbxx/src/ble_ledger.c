@@ -609,11 +609,12 @@ static int32_t hci_evt_cmd_complete(uint8_t *buffer, uint16_t length)
     }
     else if (opcode == ACI_GATT_UPDATE_CHAR_VALUE_CMD_CODE) {
         ble_profile_info_t *profile_info = NULL;
+        uint8_t             hci_status   = (length >= 4) ? buffer[3] : HCI_SUCCESS_ERR_CODE;
         for (uint8_t index = 0; index < ble_ledger_data.nb_of_profile; index++) {
             profile_info = ble_ledger_data.profile[index];
             if (profile_info->update_char_val_ack) {
                 ble_profile_status_t ble_status = ((ble_profile_update_char_value_ack_t) PIC(
-                    profile_info->update_char_val_ack))(profile_info->cookie);
+                    profile_info->update_char_val_ack))(hci_status, profile_info->cookie);
                 if (ble_status == BLE_PROFILE_STATUS_OK_AND_SEND_PACKET) {
                     send_hci_packet(0);
                 }
@@ -891,6 +892,20 @@ static int32_t hci_evt_vendor(uint8_t *buffer, uint16_t length)
             LOG_IO("PROCEDURE COMPLETE\n");
             break;
 
+        case ACI_GATT_TX_POOL_AVAILABLE_VSEVT_CODE:
+            for (uint8_t index = 0; index < ble_ledger_data.nb_of_profile; index++) {
+                ble_profile_info_t *profile_info = ble_ledger_data.profile[index];
+                if (profile_info->tx_pool_available) {
+                    ble_profile_status_t ble_status = ((ble_profile_tx_pool_available_t) PIC(
+                        profile_info->tx_pool_available))(profile_info->cookie);
+                    if (ble_status == BLE_PROFILE_STATUS_OK_AND_SEND_PACKET) {
+                        send_hci_packet(0);
+                        break;
+                    }
+                }
+            }
+            break;
+
         case ACI_GATT_PROC_TIMEOUT_VSEVT_CODE:
             LOG_IO("PROCEDURE TIMEOUT\n");
 #ifdef HAVE_INAPP_BLE_PAIRING
@@ -48,6 +48,10 @@ typedef enum create_db_step_e {
 
 /* Private defines------------------------------------------------------------*/
 #define CONN_INTERVAL_MIN 12  // 15ms
+// LE data length requested once the ATT MTU is known: a whole notification per LL PDU
+#define DATA_LENGTH_TX_OCTETS(mtu) MIN((mtu) + BLE_L2CAP_HEADER_SIZE, BLE_LL_MAX_TX_OCTETS)
+// Time to send a PDU of 'octets' bytes on the 1M PHY (preamble, access address, header, MIC, CRC)
+#define DATA_LENGTH_TX_TIME(octets) (((octets) + 14) * 8)
 
 /* Private types, structures, unions -----------------------------------------*/
 typedef struct ledger_ble_profile_apdu_handle_s {
@@ -72,8 +76,12 @@ typedef struct ledger_ble_profile_apdu_handle_s {
     uint16_t gatt_write_characteristic_handle;
     uint16_t gatt_write_cmd_characteristic_handle;
     uint8_t  mtu_negotiated;
+    uint8_t  data_length_requested;
     uint8_t  notifications_enabled;
     uint8_t  wait_write_resp_ack;
+    // Set when the controller refused a notification because its TX pool was full: the chunk
+    // is kept and notified again on ACI_GATT_TX_POOL_AVAILABLE_VSEVT
+    uint8_t  tx_pool_full;
 
     // BLE CMD
     ble_cmd_data_t *cmd_data;
@@ -163,6 +171,7 @@ const ble_profile_info_t BLE_LEDGER_PROFILE_apdu_info = {
 
     .write_rsp_ack       = BLE_LEDGER_PROFILE_apdu_write_rsp_ack,
     .update_char_val_ack = BLE_LEDGER_PROFILE_apdu_update_char_value_ack,
+    .tx_pool_available   = BLE_LEDGER_PROFILE_apdu_tx_pool_available,
 
     .send_packet = BLE_LEDGER_PROFILE_apdu_send_packet,
     .is_busy     = BLE_LEDGER_PROFILE_apdu_is_busy,
@@ -370,8 +379,10 @@ void BLE_LEDGER_PROFILE_apdu_connection_evt(ble_connection_t *connection, void *
     handle->notifications_enabled = 0;
     handle->protocol_data.mtu     = BLE_ATT_DEFAULT_MTU - 1;
     handle->mtu_negotiated        = 0;
+    handle->data_length_requested = 0;
     handle->connection_updated    = 0;
     handle->wait_write_resp_ack   = 0;
+    handle->tx_pool_full          = 0;
     handle->transfer_mode_enabled = 0;
     handle->send_response         = false;
     handle->connection            = connection;
@@ -564,6 +575,17 @@ ble_profile_status_t BLE_LEDGER_PROFILE_apdu_mtu_changed(uint16_t mtu, void *coo
         handle->protocol_data.mtu = mtu - 1;
         handle->mtu_negotiated    = 1;
         status                    = BLE_PROFILE_STATUS_OK;
+
+        // Without data length extension, a notification of a negotiated MTU is split into
+        // several 27 bytes LL PDUs, each one taking an inter frame space
+        if ((!handle->data_length_requested) && (handle->connection)) {
+            handle->data_length_requested = 1;
+            ble_hci_forge_cmd_set_data_length(handle->cmd_data,
+                                              handle->connection->connection_handle,
+                                              DATA_LENGTH_TX_OCTETS(mtu),
+                                              DATA_LENGTH_TX_TIME(DATA_LENGTH_TX_OCTETS(mtu)));
+            status = BLE_PROFILE_STATUS_OK_AND_SEND_PACKET;
+        }
     }
 
 error:
@@ -594,7 +616,7 @@ error:
     return status;
 }
 
-ble_profile_status_t BLE_LEDGER_PROFILE_apdu_update_char_value_ack(void *cookie)
+ble_profile_status_t BLE_LEDGER_PROFILE_apdu_update_char_value_ack(uint8_t hci_status, void *cookie)
 {
     ble_profile_status_t status = BLE_PROFILE_STATUS_BAD_PARAMETERS;
     if (!cookie) {
@@ -603,8 +625,15 @@ ble_profile_status_t BLE_LEDGER_PROFILE_apdu_update_char_value_ack(void *cookie)
 
     ledger_ble_profile_apdu_handle_t *handle = (ledger_ble_profile_apdu_handle_t *) PIC(cookie);
 
-    handle->protocol_data.tx_chunk_length = 0;
-    if (!handle->transfer_mode_enabled) {
+    if ((hci_status == BLE_INSUFFICIENT_RESOURCES_ERR_CODE)
+        && (handle->protocol_data.tx_chunk_length >= 2)) {
+        // Chunk not queued by the controller, wait for room in its TX pool instead of losing it
+        LOG_IO("TX POOL FULL\n");
+        handle->tx_pool_full = 1;
+        status               = BLE_PROFILE_STATUS_OK;
+    }
+    else if (!handle->transfer_mode_enabled) {
+        handle->protocol_data.tx_chunk_length = 0;
         if (handle->protocol_data.tx_apdu_buffer) {
             ledger_protocol_result_t result
                 = LEDGER_PROTOCOL_tx(&handle->protocol_data,
@@ -619,9 +648,10 @@ ble_profile_status_t BLE_LEDGER_PROFILE_apdu_update_char_value_ack(void *cookie)
             notify_chunk(handle);
             status = BLE_PROFILE_STATUS_OK_AND_SEND_PACKET;
         }
-        if (!handle->protocol_data.tx_apdu_buffer) {
-            handle->protocol_data.tx_chunk_length = 0;
-            handle->state                         = LEDGER_BLE_PROFILE_APDU_STATE_IDLE;
+        else {
+            // Last chunk acknowledged (the command buffer must not be reused before that)
+            handle->state = LEDGER_BLE_PROFILE_APDU_STATE_IDLE;
+            status        = BLE_PROFILE_STATUS_OK;
             if ((!handle->connection_updated)
                 && (handle->connection->conn_interval > BLE_SLAVE_CONN_INTERVAL_MIN)) {
                 handle->connection_updated = 1;
@@ -637,7 +667,30 @@ ble_profile_status_t BLE_LEDGER_PROFILE_apdu_update_char_value_ack(void *cookie)
         }
     }
     else {
-        status = BLE_PROFILE_STATUS_OK;
+        handle->protocol_data.tx_chunk_length = 0;
+        status                                = BLE_PROFILE_STATUS_OK;
+    }
+
+error:
+    return status;
+}
+
+ble_profile_status_t BLE_LEDGER_PROFILE_apdu_tx_pool_available(void *cookie)
+{
+    ble_profile_status_t status = BLE_PROFILE_STATUS_BAD_PARAMETERS;
+    if (!cookie) {
+        goto error;
+    }
+
+    ledger_ble_profile_apdu_handle_t *handle = (ledger_ble_profile_apdu_handle_t *) PIC(cookie);
+
+    status = BLE_PROFILE_STATUS_OK;
+    if (handle->tx_pool_full) {
+        handle->tx_pool_full = 0;
+        if (handle->protocol_data.tx_chunk_length >= 2) {
+            notify_chunk(handle);
+            status = BLE_PROFILE_STATUS_OK_AND_SEND_PACKET;
+        }
     }
 
 error:
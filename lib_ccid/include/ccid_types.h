@@ -149,7 +149,8 @@ typedef struct {
     uint16_t       tx_message_length;
     uint16_t       tx_message_offset;
 
-    uint8_t tx_packet_length;
+    const uint8_t *tx_packet;  // either the packet buffer or a slice of tx_message_buffer
+    uint8_t        tx_packet_length;
 
     ccid_protocol_data_t0_t protocol_data;
 
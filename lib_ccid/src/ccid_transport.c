@@ -145,10 +145,10 @@ void CCID_TRANSPORT_tx(ccid_transport_t *handle,
     }
 
     uint16_t tx_packet_offset = 0;
-    memset(tx_packet_buffer, 0, tx_packet_buffer_size);
+    uint16_t tx_chunk_length  = 0;
 
-    // Fill header
     if (buffer) {
+        // The header and the first bytes of the message have to be sent in the same packet
         tx_packet_buffer[0] = handle->bulk_msg_header.in.msg_type;
         U4LE_ENCODE(tx_packet_buffer, 1, handle->bulk_msg_header.in.length);
         tx_packet_buffer[5] = handle->bulk_msg_header.in.slot_number;
@@ -156,25 +156,23 @@ void CCID_TRANSPORT_tx(ccid_transport_t *handle,
         tx_packet_buffer[7] = handle->bulk_msg_header.in.status;
         tx_packet_buffer[8] = handle->bulk_msg_header.in.error;
         tx_packet_buffer[9] = handle->bulk_msg_header.in.specific;
-        tx_packet_offset    = 10;
-    }
+        tx_packet_offset    = CCID_HEADER_SIZE;
 
-    if ((handle->tx_message_length + tx_packet_offset)
-        >= (tx_packet_buffer_size + handle->tx_message_offset)) {
-        // Remaining message length doesn't fit the max packet size
-        memcpy(&tx_packet_buffer[tx_packet_offset],
-               &handle->tx_message_buffer[handle->tx_message_offset],
-               tx_packet_buffer_size - tx_packet_offset);
-        handle->tx_message_offset += tx_packet_buffer_size - tx_packet_offset;
-        tx_packet_offset = tx_packet_buffer_size;
+        tx_chunk_length = MIN(handle->tx_message_length, tx_packet_buffer_size - tx_packet_offset);
+        memcpy(&tx_packet_buffer[tx_packet_offset], handle->tx_message_buffer, tx_chunk_length);
+        handle->tx_packet = tx_packet_buffer;
     }
     else {
-        // Remaining message fits the max packet size
-        memcpy(&tx_packet_buffer[tx_packet_offset],
-               &handle->tx_message_buffer[handle->tx_message_offset],
-               handle->tx_message_length - handle->tx_message_offset);
-        tx_packet_offset += (handle->tx_message_length - handle->tx_message_offset);
-        handle->tx_message_offset = handle->tx_message_length;
+        // Continuation packets are sent straight from the message buffer
+        tx_chunk_length
+            = MIN(handle->tx_message_length - handle->tx_message_offset, tx_packet_buffer_size);
+        handle->tx_packet = &handle->tx_message_buffer[handle->tx_message_offset];
+    }
+    tx_packet_offset += tx_chunk_length;
+    handle->tx_message_offset += tx_chunk_length;
+
+    if (tx_packet_offset < tx_packet_buffer_size) {
+        // Short packet (possibly empty): end of the message
         handle->tx_message_buffer = NULL;
         handle->rx_msg_status     = CCID_MSG_STATUS_WAITING;
     }
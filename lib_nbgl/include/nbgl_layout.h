@@ -414,6 +414,39 @@ typedef struct {
     bool        largeText1;  ///< if set to true, use 32px font for text1
 } nbgl_layoutQRCode_t;
 
+#ifdef NBGL_QRCODE_ANIMATION
+/**
+ * @brief prototype of function to be called by an animated QR Code to get the text of a frame
+ *
+ * @param frameIdx index of the requested frame, starting at 0 and incremented for each new frame
+ * (for example the sequence number of a fountain-coded part)
+ * @param buffer buffer to fill with the text of the frame (NULL terminated)
+ * @param bufferLen size of buffer, in bytes
+ * @return false if there is no frame to display anymore (the last frame stays displayed)
+ */
+typedef bool (*nbgl_layoutQRCodeFrameCallback_t)(uint32_t frameIdx,
+                                                 char    *buffer,
+                                                 uint16_t bufferLen);
+
+/**
+ * @brief This structure contains info to build the same area as @ref nbgl_layoutQRCode_t, but
+ * with a QR Code cycling through a sequence of frames, to transfer a payload too large for a
+ * single QR Code (e.g. a multi-part UR)
+ *
+ * @note The version of the QR Code is chosen with the first frame, so all frames shall have
+ * about the same length
+ */
+typedef struct {
+    nbgl_layoutQRCodeFrameCallback_t getFrame;  ///< callback to get the text of each frame
+    const char                      *text1;     ///< first text (can be null)
+    const char                      *text2;     ///< second text (can be null)
+    uint16_t frameDurationMs;  ///< display duration of each frame, in ms (at least 100 ms)
+    int16_t  offsetY;          ///< vertical shift to apply to this info (if > 0, shift to bottom)
+    bool     centered;         ///< if set to true, center vertically
+    bool     largeText1;       ///< if set to true, use 32px font for text1
+} nbgl_layoutAnimatedQRCode_t;
+#endif  // NBGL_QRCODE_ANIMATION
+
 /**
  * @brief The different styles for a pair of buttons
  *
@@ -704,6 +737,9 @@ int nbgl_layoutAddTextWithAlias(nbgl_layout_t *layout,
                                 uint8_t        index);
 int nbgl_layoutAddRadioChoice(nbgl_layout_t *layout, const nbgl_layoutRadioChoice_t *choices);
 int nbgl_layoutAddQRCode(nbgl_layout_t *layout, const nbgl_layoutQRCode_t *info);
+#ifdef NBGL_QRCODE_ANIMATION
+int nbgl_layoutAddAnimatedQRCode(nbgl_layout_t *layout, const nbgl_layoutAnimatedQRCode_t *info);
+#endif  // NBGL_QRCODE_ANIMATION
 int nbgl_layoutAddChoiceButtons(nbgl_layout_t *layout, const nbgl_layoutChoiceButtons_t *info);
 int nbgl_layoutAddHorizontalButtons(nbgl_layout_t                        *layout,
                                     const nbgl_layoutHorizontalButtons_t *info);
@@ -873,6 +909,15 @@ int nbgl_layoutUpdateKeypadContent(nbgl_layout_t *layout,
 int nbgl_layoutDraw(nbgl_layout_t *layout);
 int nbgl_layoutRelease(nbgl_layout_t *layout);
 
+#ifdef NBGL_POOL_TELEMETRY
+// number of layers for which high-water marks of the pools are kept
+#define NB_TRACKED_LAYERS 8
+
+uint8_t nbgl_layoutGetObjPoolPeak(uint8_t layer);
+uint8_t nbgl_layoutGetContainerPoolPeak(uint8_t layer);
+void    nbgl_layoutResetPoolPeaks(void);
+#endif  // NBGL_POOL_TELEMETRY
+
 /**********************
  *      MACROS
  **********************/
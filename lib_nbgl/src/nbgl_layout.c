@@ -148,6 +148,13 @@
 // refresh period of the spinner, in ms
 #define SPINNER_REFRESH_PERIOD 400
 
+#ifdef NBGL_QRCODE_ANIMATION
+// max size of the text of a frame of an animated QR Code (including the NULL terminator)
+#define QR_FRAME_MAX_LEN 400
+// min display duration of a frame of an animated QR Code, in ms
+#define QR_FRAME_MIN_DURATION 100
+#endif  // NBGL_QRCODE_ANIMATION
+
 /**********************
  *      MACROS
  **********************/
@@ -179,6 +186,19 @@ typedef struct {
     tune_index_e tuneId;  // if not @ref NBGL_NO_TUNE, a tune will be played
 } listItem_t;
 
+#ifdef NBGL_QRCODE_ANIMATION
+// context of the animated QR Code (only one can be displayed at a time)
+typedef struct {
+    nbgl_layoutInternal_t           *layout;          // layout of the QR Code (NULL if none)
+    nbgl_qrcode_t                   *qrcode;          // the QR Code object
+    nbgl_layoutQRCodeFrameCallback_t getFrame;        // callback to get the text of each frame
+    uint32_t                         frameIdx;        // index of the displayed frame
+    uint8_t                          bufferIdx;       // index of the buffer of the displayed frame
+    bool                             nextFrameReady;  // true if next frame is in the other buffer
+    char frames[2][QR_FRAME_MAX_LEN];                 // displayed frame and next one, alternately
+} animatedQRCodeContext_t;
+#endif  // NBGL_QRCODE_ANIMATION
+
 /**********************
  *      VARIABLES
  **********************/
@@ -195,6 +215,10 @@ static nbgl_layoutInternal_t *topLayout;
 // numbers of touchable controls for the whole page
 static uint8_t nbTouchableControls = 0;
 
+#ifdef NBGL_QRCODE_ANIMATION
+static animatedQRCodeContext_t animatedQRCodeCtx;
+#endif  // NBGL_QRCODE_ANIMATION
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -590,6 +614,30 @@ static void animTickerCallback(void)
     }
 }
 
+#ifdef NBGL_QRCODE_ANIMATION
+// callback for animated QR Code ticker
+static void animatedQRCodeTickerCallback(void)
+{
+    animatedQRCodeContext_t *ctx = &animatedQRCodeCtx;
+
+    if ((ctx->layout == NULL) || (ctx->layout != topLayout) || !ctx->layout->isUsed
+        || !ctx->nextFrameReady) {
+        return;
+    }
+
+    // display the next frame, prepared at previous tick
+    ctx->bufferIdx ^= 1;
+    ctx->frameIdx++;
+    ctx->qrcode->text = ctx->frames[ctx->bufferIdx];
+    nbgl_objDraw((nbgl_obj_t *) ctx->qrcode);
+    nbgl_refreshSpecial(BLACK_AND_WHITE_FAST_REFRESH);
+
+    // then prepare the following one in the other buffer, while this one is displayed
+    ctx->nextFrameReady
+        = ctx->getFrame(ctx->frameIdx + 1, ctx->frames[ctx->bufferIdx ^ 1], QR_FRAME_MAX_LEN);
+}
+#endif  // NBGL_QRCODE_ANIMATION
+
 static nbgl_line_t *createHorizontalLine(uint8_t layer)
 {
     nbgl_line_t *line;
@@ -806,7 +854,7 @@ static nbgl_container_t *addListItem(nbgl_layoutInternal_t *layoutInt, const lis
         }
         textArea->obj.area.height = MAX(
             LIST_ITEM_MIN_TEXT_HEIGHT,
-            nbgl_getTextHeightInWidth(
+            layoutGetTextHeightInWidth(
                 textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping));
         textArea->style         = NO_STYLE;
         textArea->obj.alignment = TOP_LEFT;
@@ -888,7 +936,7 @@ static nbgl_container_t *addListItem(nbgl_layoutInternal_t *layoutInt, const lis
                 = -(((nbgl_icon_details_t *) PIC(itemDesc->iconLeft))->width + BAR_INTERVALE);
         }
         subTextArea->obj.area.width                = container->obj.area.width;
-        subTextArea->obj.area.height               = nbgl_getTextHeightInWidth(subTextArea->fontId,
+        subTextArea->obj.area.height               = layoutGetTextHeightInWidth(subTextArea->fontId,
                                                                  subTextArea->text,
                                                                  subTextArea->obj.area.width,
                                                                  subTextArea->wrapping);
@@ -972,7 +1020,7 @@ static nbgl_container_t *addContentCenter(nbgl_layoutInternal_t      *layoutInt,
         textArea->fontId        = LARGE_MEDIUM_FONT;
         textArea->wrapping      = true;
         textArea->obj.area.width  = AVAILABLE_WIDTH;
-        textArea->obj.area.height = nbgl_getTextHeightInWidth(
+        textArea->obj.area.height = layoutGetTextHeightInWidth(
             textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping);
 
         // if not the first child, put on bottom of the previous, with a margin
@@ -999,7 +1047,7 @@ static nbgl_container_t *addContentCenter(nbgl_layoutInternal_t      *layoutInt,
         textArea->fontId        = SMALL_BOLD_FONT;
         textArea->wrapping      = true;
         textArea->obj.area.width  = AVAILABLE_WIDTH;
-        textArea->obj.area.height = nbgl_getTextHeightInWidth(
+        textArea->obj.area.height = layoutGetTextHeightInWidth(
             textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping);
 
         // if not the first child, put on bottom of the previous, with a margin
@@ -1032,7 +1080,7 @@ static nbgl_container_t *addContentCenter(nbgl_layoutInternal_t      *layoutInt,
         textArea->fontId        = SMALL_REGULAR_FONT;
         textArea->wrapping      = true;
         textArea->obj.area.width  = AVAILABLE_WIDTH;
-        textArea->obj.area.height = nbgl_getTextHeightInWidth(
+        textArea->obj.area.height = layoutGetTextHeightInWidth(
             textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping);
 
         // if not the first child, put on bottom of the previous, with a margin
@@ -1065,7 +1113,7 @@ static nbgl_container_t *addContentCenter(nbgl_layoutInternal_t      *layoutInt,
         textArea->fontId        = SMALL_REGULAR_FONT;
         textArea->wrapping      = true;
         textArea->obj.area.width  = AVAILABLE_WIDTH;
-        textArea->obj.area.height = nbgl_getTextHeightInWidth(
+        textArea->obj.area.height = layoutGetTextHeightInWidth(
             textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping);
         // sub-text is included in a hug of 8px
         textArea->obj.area.height += 2 * 8;
@@ -1170,6 +1218,10 @@ nbgl_layout_t *nbgl_layoutGet(const nbgl_layoutDescription_t *description)
                                         (nbgl_touchCallback_t) touchCallback);
     }
     else {
+#ifdef NBGL_POOL_TELEMETRY
+        // the pools of the background layer are about to be reused
+        layoutPoolsSample(0);
+#endif  // NBGL_POOL_TELEMETRY
         nbgl_screenSet(&layout->children,
                        NB_MAX_SCREEN_CHILDREN,
                        &description->ticker,
@@ -1555,7 +1607,7 @@ int nbgl_layoutAddLargeCaseText(nbgl_layout_t *layout, const char *text, bool gr
     textArea->fontId          = LARGE_MEDIUM_FONT;
     textArea->obj.area.width  = AVAILABLE_WIDTH;
     textArea->wrapping        = true;
-    textArea->obj.area.height = nbgl_getTextHeightInWidth(
+    textArea->obj.area.height = layoutGetTextHeightInWidth(
         textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping);
     textArea->style                = NO_STYLE;
     textArea->obj.alignment        = NO_ALIGNMENT;
@@ -1608,7 +1660,7 @@ int nbgl_layoutAddTextContent(nbgl_layout_t *layout, nbgl_layoutTextContent_t *c
         textArea->obj.alignmentMarginX = BORDER_MARGIN;
         textArea->obj.alignmentMarginY = PRE_TITLE_MARGIN;
         textArea->obj.area.width       = AVAILABLE_WIDTH;
-        textArea->obj.area.height      = nbgl_getTextHeightInWidth(
+        textArea->obj.area.height      = layoutGetTextHeightInWidth(
             textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping);
         // set this new obj as child of main container
         layoutAddObject(layoutInt, (nbgl_obj_t *) textArea);
@@ -1623,7 +1675,7 @@ int nbgl_layoutAddTextContent(nbgl_layout_t *layout, nbgl_layoutTextContent_t *c
         textArea->style     = NO_STYLE;
         textArea->wrapping  = true;
         textArea->obj.area.width  = AVAILABLE_WIDTH;
-        textArea->obj.area.height = nbgl_getTextHeightInWidth(
+        textArea->obj.area.height = layoutGetTextHeightInWidth(
             textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping);
         textArea->textAlignment        = MID_LEFT;
         textArea->obj.alignment        = NO_ALIGNMENT;
@@ -1643,7 +1695,7 @@ int nbgl_layoutAddTextContent(nbgl_layout_t *layout, nbgl_layoutTextContent_t *c
         textArea->style     = NO_STYLE;
         textArea->wrapping  = true;
         textArea->obj.area.width  = AVAILABLE_WIDTH;
-        textArea->obj.area.height = nbgl_getTextHeightInWidth(
+        textArea->obj.area.height = layoutGetTextHeightInWidth(
             textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping);
         textArea->textAlignment        = MID_LEFT;
         textArea->obj.alignment        = BOTTOM_LEFT;
@@ -1873,7 +1925,7 @@ int nbgl_layoutAddLeftContent(nbgl_layout_t *layout, const nbgl_layoutLeftConten
     textArea->obj.alignmentMarginY = 24;
 #endif
     textArea->obj.area.width  = AVAILABLE_WIDTH;
-    textArea->obj.area.height = nbgl_getTextHeightInWidth(
+    textArea->obj.area.height = layoutGetTextHeightInWidth(
         textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping);
 
     container->obj.area.height += textArea->obj.area.height + textArea->obj.alignmentMarginY;
@@ -1903,7 +1955,7 @@ int nbgl_layoutAddLeftContent(nbgl_layout_t *layout, const nbgl_layoutLeftConten
         textArea->wrapping      = true;
         textArea->obj.area.width
             = AVAILABLE_WIDTH - image->buffer->width - LEFT_CONTENT_ICON_TEXT_X;
-        textArea->obj.area.height = nbgl_getTextHeightInWidth(
+        textArea->obj.area.height = layoutGetTextHeightInWidth(
             textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping);
         textArea->obj.alignment   = MID_RIGHT;
         rowContainer->children[1] = (nbgl_obj_t *) textArea;
@@ -1990,7 +2042,7 @@ int nbgl_layoutAddQRCode(nbgl_layout_t *layout, const nbgl_layoutQRCode_t *info)
         textArea->fontId   = (info->largeText1 == true) ? LARGE_MEDIUM_FONT : SMALL_REGULAR_FONT;
         textArea->wrapping = true;
         textArea->obj.area.width  = AVAILABLE_WIDTH;
-        textArea->obj.area.height = nbgl_getTextHeightInWidth(
+        textArea->obj.area.height = layoutGetTextHeightInWidth(
             textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping);
         textArea->obj.alignment = BOTTOM_MIDDLE;
         textArea->obj.alignTo   = (nbgl_obj_t *) container->children[container->nbChildren - 1];
@@ -2009,7 +2061,7 @@ int nbgl_layoutAddQRCode(nbgl_layout_t *layout, const nbgl_layoutQRCode_t *info)
         textArea->fontId        = SMALL_REGULAR_FONT;
         textArea->wrapping      = true;
         textArea->obj.area.width  = AVAILABLE_WIDTH;
-        textArea->obj.area.height = nbgl_getTextHeightInWidth(
+        textArea->obj.area.height = layoutGetTextHeightInWidth(
             textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping);
         textArea->obj.alignment = BOTTOM_MIDDLE;
         textArea->obj.alignTo   = (nbgl_obj_t *) container->children[container->nbChildren - 1];
@@ -2053,6 +2105,64 @@ int nbgl_layoutAddQRCode(nbgl_layout_t *layout, const nbgl_layoutQRCode_t *info)
 
     return fullHeight;
 }
+
+#ifdef NBGL_QRCODE_ANIMATION
+/**
+ * @brief Creates the same area as @ref nbgl_layoutAddQRCode(), but with a QR Code cycling through
+ * a sequence of frames provided by the given callback, at the given pace
+ *
+ * @note The first two frames are requested immediately, then each following frame is requested
+ * once the previous one is displayed, so that it is ready at next tick. Only one animated QR Code
+ * can be displayed at a time.
+ *
+ * @param layout the current layout
+ * @param info structure giving the description of the QR Code and its frames
+ * @return height of the control if OK
+ */
+int nbgl_layoutAddAnimatedQRCode(nbgl_layout_t *layout, const nbgl_layoutAnimatedQRCode_t *info)
+{
+    nbgl_layoutInternal_t           *layoutInt = (nbgl_layoutInternal_t *) layout;
+    animatedQRCodeContext_t         *ctx       = &animatedQRCodeCtx;
+    nbgl_container_t                *container;
+    nbgl_layoutQRCode_t              qrCodeInfo;
+    nbgl_screenTickerConfiguration_t tickerCfg = {0};
+    int                              height;
+
+    LOG_DEBUG(LAYOUT_LOGGER, "nbgl_layoutAddAnimatedQRCode():\n");
+    if ((layout == NULL) || (info->getFrame == NULL)) {
+        return -1;
+    }
+
+    memset(ctx, 0, sizeof(animatedQRCodeContext_t));
+    ctx->getFrame = PIC(info->getFrame);
+    if (!ctx->getFrame(0, ctx->frames[0], QR_FRAME_MAX_LEN)) {
+        return -1;
+    }
+    ctx->nextFrameReady = ctx->getFrame(1, ctx->frames[1], QR_FRAME_MAX_LEN);
+
+    qrCodeInfo.url        = ctx->frames[0];
+    qrCodeInfo.text1      = info->text1;
+    qrCodeInfo.text2      = info->text2;
+    qrCodeInfo.offsetY    = info->offsetY;
+    qrCodeInfo.centered   = info->centered;
+    qrCodeInfo.largeText1 = info->largeText1;
+    height                = nbgl_layoutAddQRCode(layout, &qrCodeInfo);
+
+    // the QR Code is the first child of the container just added
+    container
+        = (nbgl_container_t *) layoutInt->container->children[layoutInt->container->nbChildren - 1];
+    ctx->qrcode = (nbgl_qrcode_t *) container->children[0];
+    ctx->layout = layoutInt;
+
+    // update ticker to display the frames periodically
+    tickerCfg.tickerIntervale = MAX(info->frameDurationMs, QR_FRAME_MIN_DURATION);  // ms
+    tickerCfg.tickerValue     = tickerCfg.tickerIntervale;                          // ms
+    tickerCfg.tickerCallback  = &animatedQRCodeTickerCallback;
+    nbgl_screenUpdateTicker(layoutInt->layer, &tickerCfg);
+
+    return height;
+}
+#endif  // NBGL_QRCODE_ANIMATION
 #endif  // NBGL_QRCODE
 
 /**
@@ -2168,7 +2278,7 @@ int nbgl_layoutAddTagValueList(nbgl_layout_t *layout, const nbgl_layoutTagValueL
         itemTextArea->fontId          = SMALL_REGULAR_FONT;
         itemTextArea->wrapping        = true;
         itemTextArea->obj.area.width  = AVAILABLE_WIDTH;
-        itemTextArea->obj.area.height = nbgl_getTextHeightInWidth(
+        itemTextArea->obj.area.height = layoutGetTextHeightInWidth(
             itemTextArea->fontId, itemTextArea->text, AVAILABLE_WIDTH, itemTextArea->wrapping);
         container->children[container->nbChildren] = (nbgl_obj_t *) itemTextArea;
         container->nbChildren++;
@@ -2204,10 +2314,10 @@ int nbgl_layoutAddTagValueList(nbgl_layout_t *layout, const nbgl_layoutTagValueL
 
         // handle the nbMaxLinesForValue parameter, used to automatically keep only
         // nbMaxLinesForValue lines
-        uint16_t nbLines = nbgl_getTextNbLinesInWidth(valueTextArea->fontId,
-                                                      valueTextArea->text,
-                                                      valueTextArea->obj.area.width,
-                                                      list->wrapping);
+        uint16_t nbLines = layoutGetTextNbLinesInWidth(valueTextArea->fontId,
+                                                       valueTextArea->text,
+                                                       valueTextArea->obj.area.width,
+                                                       list->wrapping);
         // use this nbMaxLinesForValue parameter only if >0
         if ((list->nbMaxLinesForValue > 0) && (nbLines > list->nbMaxLinesForValue)) {
             nbLines                          = list->nbMaxLinesForValue;
@@ -2363,7 +2473,7 @@ int nbgl_layoutAddProgressBar(nbgl_layout_t *layout,
     textArea->obj.alignTo          = (nbgl_obj_t *) progress;
     textArea->obj.alignment        = BOTTOM_MIDDLE;
     textArea->obj.area.width       = AVAILABLE_WIDTH;
-    textArea->obj.area.height      = nbgl_getTextHeightInWidth(
+    textArea->obj.area.height      = layoutGetTextHeightInWidth(
         textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping);
     textArea->style = NO_STYLE;
 
@@ -2386,7 +2496,7 @@ int nbgl_layoutAddProgressBar(nbgl_layout_t *layout,
         subTextArea->obj.alignTo          = (nbgl_obj_t *) textArea;
         subTextArea->obj.alignment        = BOTTOM_MIDDLE;
         subTextArea->obj.area.width       = AVAILABLE_WIDTH;
-        subTextArea->obj.area.height      = nbgl_getTextHeightInWidth(subTextArea->fontId,
+        subTextArea->obj.area.height      = layoutGetTextHeightInWidth(subTextArea->fontId,
                                                                  subTextArea->text,
                                                                  subTextArea->obj.area.width,
                                                                  subTextArea->wrapping);
@@ -2501,7 +2611,7 @@ int nbgl_layoutAddButton(nbgl_layout_t *layout, const nbgl_layoutButton_t *butto
     button->fontId = SMALL_BOLD_FONT;
     button->icon   = PIC(buttonInfo->icon);
     if (buttonInfo->fittingContent == true) {
-        button->obj.area.width = nbgl_getTextWidth(button->fontId, button->text)
+        button->obj.area.width = layoutGetTextWidth(button->fontId, button->text)
                                  + SMALL_BUTTON_HEIGHT
                                  + ((button->icon) ? (button->icon->width + 12) : 0);
         button->obj.area.height = SMALL_BUTTON_HEIGHT;
@@ -2724,10 +2834,10 @@ int nbgl_layoutAddHeader(nbgl_layout_t *layout, const nbgl_layoutHeader_t *heade
                 textArea->wrapping        = true;
                 uint8_t nbMaxLines        = (headerDesc->type == HEADER_BACK_ICON_AND_TEXT) ? 1 : 2;
                 // ensure that text fits on 2 lines maximum
-                if (nbgl_getTextNbLinesInWidth(textArea->fontId,
-                                               textArea->text,
-                                               textArea->obj.area.width,
-                                               textArea->wrapping)
+                if (layoutGetTextNbLinesInWidth(textArea->fontId,
+                                                textArea->text,
+                                                textArea->obj.area.width,
+                                                textArea->wrapping)
                     > nbMaxLines) {
                     textArea->obj.area.height
                         = nbMaxLines * nbgl_getFontLineHeight(textArea->fontId);
@@ -2738,7 +2848,7 @@ int nbgl_layoutAddHeader(nbgl_layout_t *layout, const nbgl_layoutHeader_t *heade
 #endif  // BUILD_SCREENSHOTS
                 }
                 if (headerDesc->type == HEADER_BACK_ICON_AND_TEXT) {
-                    textArea->obj.area.width = nbgl_getTextWidth(textArea->fontId, textArea->text);
+                    textArea->obj.area.width = layoutGetTextWidth(textArea->fontId, textArea->text);
                 }
                 layoutInt->headerContainer->children[layoutInt->headerContainer->nbChildren]
                     = (nbgl_obj_t *) textArea;
@@ -2807,10 +2917,10 @@ int nbgl_layoutAddHeader(nbgl_layout_t *layout, const nbgl_layoutHeader_t *heade
                 subTextArea->obj.alignmentMarginY = SUB_HEADER_MARGIN;
                 subTextArea->obj.area.width       = AVAILABLE_WIDTH;
                 subTextArea->obj.area.height
-                    = nbgl_getTextHeightInWidth(subTextArea->fontId,
-                                                subTextArea->text,
-                                                subTextArea->obj.area.width,
-                                                subTextArea->wrapping);
+                    = layoutGetTextHeightInWidth(subTextArea->fontId,
+                                                 subTextArea->text,
+                                                 subTextArea->obj.area.width,
+                                                 subTextArea->wrapping);
                 layoutInt->headerContainer->children[layoutInt->headerContainer->nbChildren]
                     = (nbgl_obj_t *) subTextArea;
                 layoutInt->headerContainer->nbChildren++;
@@ -3448,7 +3558,7 @@ int nbgl_layoutAddUpFooter(nbgl_layout_t *layout, const nbgl_layoutUpFooter_t *u
             textArea->fontId          = LARGE_MEDIUM_FONT;
             textArea->wrapping        = true;
             textArea->obj.area.width  = SCREEN_WIDTH - 3 * BORDER_MARGIN - button->obj.area.width;
-            textArea->obj.area.height = nbgl_getTextHeightInWidth(
+            textArea->obj.area.height = layoutGetTextHeightInWidth(
                 textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping);
             textArea->style                           = NO_STYLE;
             textArea->obj.alignment                   = MID_LEFT;
@@ -3613,7 +3723,7 @@ int nbgl_layoutAddUpFooter(nbgl_layout_t *layout, const nbgl_layoutUpFooter_t *u
                     -= ((nbgl_icon_details_t *) PIC(upFooterDesc->tipBox.icon))->width
                        + TIP_BOX_TEXT_ICON_MARGIN;
             }
-            textArea->obj.area.height = nbgl_getTextHeightInWidth(
+            textArea->obj.area.height = layoutGetTextHeightInWidth(
                 textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping);
             textArea->obj.alignment                       = MID_LEFT;
             textArea->obj.alignmentMarginX                = BORDER_MARGIN;
@@ -3662,7 +3772,7 @@ int nbgl_layoutAddUpFooter(nbgl_layout_t *layout, const nbgl_layoutUpFooter_t *u
                 textArea->fontId          = SMALL_REGULAR_FONT;
                 textArea->wrapping        = true;
                 textArea->obj.area.width  = AVAILABLE_WIDTH;
-                textArea->obj.area.height = nbgl_getTextHeightInWidth(
+                textArea->obj.area.height = layoutGetTextHeightInWidth(
                     textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping);
                 textArea->obj.alignment                   = CENTER;
                 layoutInt->upFooterContainer->children[0] = (nbgl_obj_t *) textArea;
@@ -3772,7 +3882,7 @@ int nbgl_layoutAddSpinner(nbgl_layout_t *layout,
     textArea->obj.alignTo          = (nbgl_obj_t *) spinner;
     textArea->obj.alignment        = BOTTOM_MIDDLE;
     textArea->obj.area.width       = AVAILABLE_WIDTH;
-    textArea->obj.area.height      = nbgl_getTextHeightInWidth(
+    textArea->obj.area.height      = layoutGetTextHeightInWidth(
         textArea->fontId, textArea->text, textArea->obj.area.width, textArea->wrapping);
     textArea->style = NO_STYLE;
 
@@ -3795,7 +3905,7 @@ int nbgl_layoutAddSpinner(nbgl_layout_t *layout,
         subTextArea->obj.alignTo          = (nbgl_obj_t *) textArea;
         subTextArea->obj.alignment        = BOTTOM_MIDDLE;
         subTextArea->obj.area.width       = AVAILABLE_WIDTH;
-        subTextArea->obj.area.height      = nbgl_getTextHeightInWidth(subTextArea->fontId,
+        subTextArea->obj.area.height      = layoutGetTextHeightInWidth(subTextArea->fontId,
                                                                  subTextArea->text,
                                                                  subTextArea->obj.area.width,
                                                                  subTextArea->wrapping);
@@ -3943,6 +4053,9 @@ int nbgl_layoutDraw(nbgl_layout_t *layoutParam)
         layout->children[LEFT_BORDER_INDEX] = (nbgl_obj_t *) line;
     }
 #endif  // TARGET_STAX
+#ifdef NBGL_POOL_TELEMETRY
+    layoutPoolsSample(layout->layer);
+#endif  // NBGL_POOL_TELEMETRY
     nbgl_screenRedraw();
 
     return 0;
@@ -3961,6 +4074,9 @@ int nbgl_layoutRelease(nbgl_layout_t *layoutParam)
     if ((layout == NULL) || (!layout->isUsed)) {
         return -1;
     }
+#ifdef NBGL_POOL_TELEMETRY
+    layoutPoolsSample(layout->layer);
+#endif  // NBGL_POOL_TELEMETRY
     // if modal
     if (layout->modal) {
         nbgl_screenPop(layout->layer);
@@ -3976,6 +4092,13 @@ int nbgl_layoutRelease(nbgl_layout_t *layoutParam)
         }
     }
     layout->isUsed = false;
+#ifdef NBGL_QRCODE_ANIMATION
+    if (animatedQRCodeCtx.layout == layout) {
+        animatedQRCodeCtx.layout = NULL;
+    }
+#endif  // NBGL_QRCODE_ANIMATION
+    // the measured strings may be overwritten once the layout is released
+    layoutTextCacheInvalidate();
     return 0;
 }
 
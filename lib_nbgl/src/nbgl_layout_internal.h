@@ -129,6 +129,20 @@ bool layoutNavigationCallback(nbgl_obj_t      *obj,
                               nbgl_touchType_t eventType,
                               uint8_t          nbPages,
                               uint8_t         *activePage);
+uint16_t layoutGetTextHeightInWidth(nbgl_font_id_e fontId,
+                                    const char    *text,
+                                    uint16_t       maxWidth,
+                                    bool           wrapping);
+uint16_t layoutGetTextNbLinesInWidth(nbgl_font_id_e fontId,
+                                     const char    *text,
+                                     uint16_t       maxWidth,
+                                     bool           wrapping);
+uint16_t layoutGetTextWidth(nbgl_font_id_e fontId, const char *text);
+void     layoutTextCacheInvalidate(void);
+void     layoutTextCacheGetStats(uint32_t *nbHits, uint32_t *nbMisses);
+#ifdef NBGL_POOL_TELEMETRY
+void layoutPoolsSample(uint8_t layer);
+#endif  // NBGL_POOL_TELEMETRY
 
 /**********************
  *      MACROS
@@ -49,6 +49,9 @@ typedef struct nbgl_layoutInternal_s {
  * GLOBAL PROTOTYPES
  **********************/
 void layoutAddObject(nbgl_layoutInternal_t *layout, nbgl_obj_t *obj);
+#ifdef NBGL_POOL_TELEMETRY
+void layoutPoolsSample(uint8_t layer);
+#endif  // NBGL_POOL_TELEMETRY
 
 /**********************
  *      MACROS
@@ -151,6 +151,20 @@ static nbgl_image_t *partialButtonImages[2];
  *  STATIC PROTOTYPES
  **********************/
 
+// builds the 'number.' text of the text entry, and returns true if it has changed, meaning that
+// its text area needs to be redrawn
+static bool updateNumText(uint8_t number)
+{
+    char newText[sizeof(numText)];
+
+    snprintf(newText, sizeof(newText), "%d.", number);
+    if (strcmp(newText, numText) == 0) {
+        return false;
+    }
+    memcpy(numText, newText, sizeof(numText));
+    return true;
+}
+
 // function used on Flex to display (or not) beginning of next button and/or end of
 // previous button, and update buttons when swipping
 static bool updateSuggestionButtons(nbgl_layoutInternal_t *layoutInt,
@@ -665,6 +679,11 @@ int nbgl_layoutUpdateKeyboard(nbgl_layout_t *layout,
             LAYOUT_LOGGER, "nbgl_layoutUpdateKeyboard(): keyboard not found at index %d\n", index);
         return -1;
     }
+    // the keyboard covers a large part of the screen, so only redraw it (and add its area to the
+    // area to refresh) if its keys have changed
+    if ((keyboard->keyMask == keyMask) && (!updateCasing || (keyboard->casing == casing))) {
+        return 0;
+    }
     keyboard->keyMask = keyMask;
     if (updateCasing) {
         keyboard->casing = casing;
@@ -848,9 +867,10 @@ int nbgl_layoutUpdateEnteredText(nbgl_layout_t *layout,
             LOG_WARN(LAYOUT_LOGGER, "nbgl_layoutUpdateEnteredText(): number area not found\n");
             return -1;
         }
-        snprintf(numText, sizeof(numText), "%d.", number);
         textArea->text = numText;
-        nbgl_objDraw((nbgl_obj_t *) textArea);
+        if (updateNumText(number)) {
+            nbgl_objDraw((nbgl_obj_t *) textArea);
+        }
     }
     // if the text doesn't fit, indicate it by returning 1 instead of 0, for different refresh
     if (nbgl_getSingleLineTextWidth(textArea->fontId, text) > textArea->obj.area.width) {
@@ -1081,8 +1101,9 @@ int nbgl_layoutUpdateKeyboardContent(nbgl_layout_t *layout, nbgl_layoutKeyboardC
     if (content->numbered) {
         // get Word number typed text
         textArea = (nbgl_text_area_t *) container->children[NUMBER_INDEX];
-        snprintf(numText, sizeof(numText), "%d.", content->number);
-        nbgl_objDraw((nbgl_obj_t *) textArea);
+        if (updateNumText(content->number)) {
+            nbgl_objDraw((nbgl_obj_t *) textArea);
+        }
     }
 
     // get text area for entered text
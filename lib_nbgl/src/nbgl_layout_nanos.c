@@ -166,6 +166,10 @@ nbgl_layout_t *nbgl_layoutGet(const nbgl_layoutDescription_t *description)
                                         (nbgl_buttonCallback_t) buttonCallback);
     }
     else {
+#ifdef NBGL_POOL_TELEMETRY
+        // the pools of the background layer are about to be reused
+        layoutPoolsSample(0);
+#endif  // NBGL_POOL_TELEMETRY
         nbgl_screenSet(&layout->children,
                        NB_MAX_SCREEN_CHILDREN,
                        &description->ticker,
@@ -802,6 +806,9 @@ int nbgl_layoutDraw(nbgl_layout_t *layoutParam)
         return -1;
     }
     LOG_DEBUG(LAYOUT_LOGGER, "nbgl_layoutDraw(): layout->nbChildren = %d\n", layout->nbChildren);
+#ifdef NBGL_POOL_TELEMETRY
+    layoutPoolsSample(layout->layer);
+#endif  // NBGL_POOL_TELEMETRY
     nbgl_screenRedraw();
 
     return 0;
@@ -820,6 +827,9 @@ int nbgl_layoutRelease(nbgl_layout_t *layoutParam)
     if (layout == NULL) {
         return -1;
     }
+#ifdef NBGL_POOL_TELEMETRY
+    layoutPoolsSample(layout->layer);
+#endif  // NBGL_POOL_TELEMETRY
     // if modal
     if (layout->modal) {
         nbgl_screenPop(layout->layer);
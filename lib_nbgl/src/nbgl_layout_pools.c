@@ -0,0 +1,97 @@
+/**
+ * @file nbgl_layout_pools.c
+ * @brief Telemetry of the occupancy of the objects pools used by layouts
+ *
+ * The objects and container pools are provided by the OS per screen layer, and released when the
+ * layer is. Their current occupancy is sampled when a layout is drawn or released (and before the
+ * background layer is reused), to keep per-layer high-water marks.
+ *
+ * @note nbgl_objPoolGetNbUsed() and nbgl_containerPoolGetNbUsed() are not available as syscalls,
+ * so this is only available when NBGL is linked with the application (screenshots, fuzzing)
+ */
+
+#ifdef NBGL_POOL_TELEMETRY
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "nbgl_obj.h"
+#ifdef HAVE_SE_TOUCH
+#include "nbgl_layout_internal.h"
+#else  // HAVE_SE_TOUCH
+#include "nbgl_layout_internal_nanos.h"
+#endif  // HAVE_SE_TOUCH
+#include "os_math.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint8_t nbObjs;            ///< max number of objects used in the objects pool
+    uint8_t nbContainerSlots;  ///< max number of slots used in the container pool
+} layerPoolsPeak_t;
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static layerPoolsPeak_t poolsPeaks[NB_TRACKED_LAYERS];
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * @brief Samples the current occupancy of the pools of the given layer, to update its
+ * high-water marks
+ *
+ * @param layer layer of the pools
+ */
+void layoutPoolsSample(uint8_t layer)
+{
+    if (layer >= NB_TRACKED_LAYERS) {
+        return;
+    }
+    poolsPeaks[layer].nbObjs = MAX(poolsPeaks[layer].nbObjs, nbgl_objPoolGetNbUsed(layer));
+    poolsPeaks[layer].nbContainerSlots
+        = MAX(poolsPeaks[layer].nbContainerSlots, nbgl_containerPoolGetNbUsed(layer));
+}
+
+/**
+ * @brief Gets the max number of objects used at once in the objects pool of the given layer
+ *
+ * @param layer layer of the pool
+ * @return the high-water mark of the objects pool
+ */
+uint8_t nbgl_layoutGetObjPoolPeak(uint8_t layer)
+{
+    if (layer >= NB_TRACKED_LAYERS) {
+        return 0;
+    }
+    return poolsPeaks[layer].nbObjs;
+}
+
+/**
+ * @brief Gets the max number of slots used at once in the container pool of the given layer
+ *
+ * @param layer layer of the pool
+ * @return the high-water mark of the container pool
+ */
+uint8_t nbgl_layoutGetContainerPoolPeak(uint8_t layer)
+{
+    if (layer >= NB_TRACKED_LAYERS) {
+        return 0;
+    }
+    return poolsPeaks[layer].nbContainerSlots;
+}
+
+/**
+ * @brief Resets the high-water marks of the pools of all layers
+ *
+ */
+void nbgl_layoutResetPoolPeaks(void)
+{
+    memset(poolsPeaks, 0, sizeof(poolsPeaks));
+}
+
+#endif  // NBGL_POOL_TELEMETRY
@@ -0,0 +1,209 @@
+
+/**
+ * @file nbgl_layout_text_cache.c
+ * @brief Cache of the text measurements done while building layouts and paginating use-cases
+ *
+ * The same strings are usually measured several times for a single page: when the use-case
+ * computes how many elements fit in the page, then when the layout sizes the text areas.
+ * Each measurement parses the whole string in the OS, so the last results are kept here.
+ *
+ * An entry is keyed by the string address, its length and a fingerprint of its content, so
+ * that a buffer rewritten in place by the application (as in streaming reviews) is measured
+ * again. The cache is also invalidated when a layout is released.
+ */
+
+#ifdef HAVE_SE_TOUCH
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "nbgl_debug.h"
+#include "nbgl_fonts.h"
+#include "nbgl_layout_internal.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#ifndef LAYOUT_TEXT_CACHE_LEN
+#define LAYOUT_TEXT_CACHE_LEN 16
+#endif  // LAYOUT_TEXT_CACHE_LEN
+
+// value of a not yet measured field of an entry
+#define UNKNOWN_MEASURE 0xFFFF
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    const char *text;         ///< address of the measured string (NULL if entry is unused)
+    uint32_t    fingerprint;  ///< FNV-1a hash of the string content
+    uint16_t    length;       ///< length of the string
+    uint16_t    maxWidth;     ///< width used to measure, 0 for single line width
+    uint16_t    nbLines;      ///< number of lines in maxWidth, or @ref UNKNOWN_MEASURE
+    uint16_t    height;       ///< height in maxWidth, or @ref UNKNOWN_MEASURE
+    uint16_t    width;        ///< width of the longest line, or @ref UNKNOWN_MEASURE
+    uint8_t     fontId;       ///< font used to measure
+    bool        wrapping;     ///< wrapping used to measure
+} textCacheEntry_t;
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static textCacheEntry_t textCache[LAYOUT_TEXT_CACHE_LEN];
+static uint8_t          textCacheNext;  // index of the next entry to replace
+static uint32_t         textCacheHits;
+static uint32_t         textCacheMisses;
+
+/**********************
+ *  STATIC FUNCTIONS
+ **********************/
+
+/**
+ * @brief Returns the entry matching the given string and measurement parameters, creating it
+ * (with unknown measures) if it is not in the cache yet
+ */
+static textCacheEntry_t *getEntry(nbgl_font_id_e fontId,
+                                  const char    *text,
+                                  uint16_t       maxWidth,
+                                  bool           wrapping)
+{
+    uint32_t          fingerprint = 2166136261u;
+    uint16_t          length      = 0;
+    textCacheEntry_t *entry;
+    uint8_t           i;
+
+    // compute length and fingerprint in a single pass
+    while (text[length] != '\0') {
+        fingerprint = (fingerprint ^ (uint8_t) text[length]) * 16777619u;
+        length++;
+    }
+
+    for (i = 0; i < LAYOUT_TEXT_CACHE_LEN; i++) {
+        entry = &textCache[i];
+        if ((entry->text == text) && (entry->length == length)
+            && (entry->fingerprint == fingerprint) && (entry->fontId == fontId)
+            && (entry->maxWidth == maxWidth) && (entry->wrapping == wrapping)) {
+            return entry;
+        }
+    }
+
+    // not found, replace the oldest entry
+    entry = &textCache[textCacheNext];
+    textCacheNext++;
+    if (textCacheNext == LAYOUT_TEXT_CACHE_LEN) {
+        textCacheNext = 0;
+    }
+    entry->text        = text;
+    entry->fingerprint = fingerprint;
+    entry->length      = length;
+    entry->maxWidth    = maxWidth;
+    entry->fontId      = fontId;
+    entry->wrapping    = wrapping;
+    entry->nbLines     = UNKNOWN_MEASURE;
+    entry->height      = UNKNOWN_MEASURE;
+    entry->width       = UNKNOWN_MEASURE;
+    return entry;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * @brief Same as @ref nbgl_getTextHeightInWidth(), with the result taken from the cache if
+ * available
+ */
+uint16_t layoutGetTextHeightInWidth(nbgl_font_id_e fontId,
+                                    const char    *text,
+                                    uint16_t       maxWidth,
+                                    bool           wrapping)
+{
+    textCacheEntry_t *entry;
+
+    if (text == NULL) {
+        return nbgl_getTextHeightInWidth(fontId, text, maxWidth, wrapping);
+    }
+    entry = getEntry(fontId, text, maxWidth, wrapping);
+    if (entry->height == UNKNOWN_MEASURE) {
+        textCacheMisses++;
+        entry->height = nbgl_getTextHeightInWidth(fontId, text, maxWidth, wrapping);
+    }
+    else {
+        textCacheHits++;
+    }
+    return entry->height;
+}
+
+/**
+ * @brief Same as @ref nbgl_getTextNbLinesInWidth(), with the result taken from the cache if
+ * available
+ */
+uint16_t layoutGetTextNbLinesInWidth(nbgl_font_id_e fontId,
+                                     const char    *text,
+                                     uint16_t       maxWidth,
+                                     bool           wrapping)
+{
+    textCacheEntry_t *entry;
+
+    if (text == NULL) {
+        return nbgl_getTextNbLinesInWidth(fontId, text, maxWidth, wrapping);
+    }
+    entry = getEntry(fontId, text, maxWidth, wrapping);
+    if (entry->nbLines == UNKNOWN_MEASURE) {
+        textCacheMisses++;
+        entry->nbLines = nbgl_getTextNbLinesInWidth(fontId, text, maxWidth, wrapping);
+    }
+    else {
+        textCacheHits++;
+    }
+    return entry->nbLines;
+}
+
+/**
+ * @brief Same as @ref nbgl_getTextWidth(), with the result taken from the cache if available
+ */
+uint16_t layoutGetTextWidth(nbgl_font_id_e fontId, const char *text)
+{
+    textCacheEntry_t *entry;
+
+    if (text == NULL) {
+        return nbgl_getTextWidth(fontId, text);
+    }
+    entry = getEntry(fontId, text, 0, false);
+    if (entry->width == UNKNOWN_MEASURE) {
+        textCacheMisses++;
+        entry->width = nbgl_getTextWidth(fontId, text);
+    }
+    else {
+        textCacheHits++;
+    }
+    return entry->width;
+}
+
+/**
+ * @brief Forgets all the measurements kept in the cache (hit/miss counters are kept)
+ */
+void layoutTextCacheInvalidate(void)
+{
+    LOG_DEBUG(LAYOUT_LOGGER,
+              "layoutTextCacheInvalidate(): hits = %d, misses = %d\n",
+              textCacheHits,
+              textCacheMisses);
+    memset(textCache, 0, sizeof(textCache));
+    textCacheNext = 0;
+}
+
+/**
+ * @brief Gets the number of measurements served from the cache and done by the OS since boot
+ *
+ * @param nbHits number of measurements served from the cache
+ * @param nbMisses number of measurements done by the OS
+ */
+void layoutTextCacheGetStats(uint32_t *nbHits, uint32_t *nbMisses)
+{
+    *nbHits   = textCacheHits;
+    *nbMisses = textCacheMisses;
+}
+
+#endif  // HAVE_SE_TOUCH
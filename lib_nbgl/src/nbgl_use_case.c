@@ -12,6 +12,7 @@
 #include <stdio.h>
 #include "nbgl_debug.h"
 #include "nbgl_use_case.h"
+#include "nbgl_layout_internal.h"
 #include "glyphs.h"
 #include "os_io_seph_ux.h"
 #include "os_pic.h"
@@ -116,6 +117,15 @@ typedef struct DetailsContext_s {
     const char *nextPageStart;
 } DetailsContext_t;
 
+// last tag/value pair measured when paginating a content, which is the first one of the next
+// page if it didn't fit in the previous one
+typedef struct TagValueMeasure_s {
+    const nbgl_contentTagValue_t *pair;  // NULL if no pair has been measured
+    uint16_t                      height;
+    uint16_t                      nbLines;
+    uint8_t                       index;
+} TagValueMeasure_t;
+
 typedef struct AddressConfirmationContext_s {
     nbgl_layoutTagValue_t tagValuePairs[ADDR_VERIF_NB_PAIRS];
     nbgl_layout_t        *modalLayout;
@@ -241,7 +251,9 @@ typedef struct {
     nbgl_choiceCallback_t      choiceCallback;
     nbgl_callback_t            skipCallback;
     const nbgl_icon_details_t *icon;
-    uint8_t                    stepPageNb;
+    uint8_t                    stepPageNb;      // nb pages of the step (paginated so far)
+    uint8_t                    nextElementIdx;  // first pair of the step not paginated yet
+    bool                       isPaginated;     // true if all pairs of the step are paginated
 } nbgl_reviewStreamingContext_t;
 
 typedef union {
@@ -298,6 +310,9 @@ static GenericContext_t genericContext;
 static nbgl_content_t
     localContentsList[3];  // 3 needed for nbgl_useCaseReview (starting page / tags / final page)
 static uint8_t genericContextPagesInfo[MAX_PAGE_NB / PAGES_PER_UINT8];
+// content of each page (-1 for STARTING_CONTENT, nbContents for FINISHING_CONTENT), to display any
+// page without walking through the previous ones
+static int8_t  genericContextPagesContentIdx[MAX_PAGE_NB];
 static uint8_t modalContextPagesInfo[MAX_MODAL_PAGE_NB / PAGES_PER_UINT8];
 
 // contexts for bundle navigation
@@ -385,6 +400,7 @@ static void bundleNavStartSettingsAtPage(uint8_t initSettingPage);
 static void bundleNavStartSettings(void);
 
 static void           bundleNavReviewStreamingChoice(bool confirm);
+static void           streamingPaginateNextPage(void);
 static nbgl_layout_t *displayModalDetails(const nbgl_warningDetails_t *details, uint8_t token);
 static void           displaySecurityReport(uint32_t set);
 static void           displayCustomizedSecurityReport(const nbgl_warningDetails_t *details);
@@ -427,10 +443,15 @@ static void reset_callbacks_and_context(void)
 }
 
 // Helper to set genericContext page info
-static void genericContextSetPageInfo(uint8_t pageIdx, uint8_t nbElements, bool flag)
+static void genericContextSetPageInfo(uint8_t pageIdx,
+                                      int8_t  contentIdx,
+                                      uint8_t nbElements,
+                                      bool    flag)
 {
     uint8_t pageData = SET_PAGE_NB_ELEMENTS(nbElements) + SET_PAGE_FLAG(flag);
 
+    genericContextPagesContentIdx[pageIdx] = contentIdx;
+
     genericContextPagesInfo[pageIdx / PAGES_PER_UINT8]
         &= ~(0x0F << ((pageIdx % PAGES_PER_UINT8) * PAGE_DATA_BITS));
     genericContextPagesInfo[pageIdx / PAGES_PER_UINT8]
@@ -450,6 +471,22 @@ static void genericContextGetPageInfo(uint8_t pageIdx, uint8_t *nbElements, bool
     }
 }
 
+// Helper to get the index of the first element of a genericContext page in its content, from the
+// number of elements of the previous pages of this content
+static uint8_t genericContextGetPageElementIdx(uint8_t pageIdx)
+{
+    int8_t  contentIdx = genericContextPagesContentIdx[pageIdx];
+    uint8_t elementIdx = 0;
+    uint8_t nbElements;
+
+    while ((pageIdx > 0) && (genericContextPagesContentIdx[pageIdx - 1] == contentIdx)) {
+        pageIdx--;
+        genericContextGetPageInfo(pageIdx, &nbElements, NULL);
+        elementIdx += nbElements;
+    }
+    return elementIdx;
+}
+
 // Helper to set modalContext page info
 static void modalContextSetPageInfo(uint8_t pageIdx, uint8_t nbElements)
 {
@@ -933,47 +970,12 @@ static const nbgl_content_t *genericContextComputeNextPageParams(uint8_t
                                                                  uint8_t *p_nbElementsInNextPage,
                                                                  bool    *p_flag)
 {
-    int8_t  nextContentIdx = genericContext.currentContentIdx;
-    int16_t nextElementIdx = genericContext.currentElementIdx;
-    uint8_t nbElementsInNextPage;
+    // The position of the page has been recorded when computing the number of pages
+    int8_t  nextContentIdx = genericContextPagesContentIdx[pageIdx];
+    int16_t nextElementIdx = genericContextGetPageElementIdx(pageIdx);
 
     // Retrieve info on the next page
-    genericContextGetPageInfo(pageIdx, &nbElementsInNextPage, p_flag);
-    *p_nbElementsInNextPage = nbElementsInNextPage;
-
-    // Handle forward navigation:
-    // add to current index the number of pairs of the currently active page
-    if (pageIdx > navInfo.activePage) {
-        uint8_t nbElementsInCurrentPage;
-
-        genericContextGetPageInfo(navInfo.activePage, &nbElementsInCurrentPage, NULL);
-        nextElementIdx += nbElementsInCurrentPage;
-
-        // Handle case where the content to be displayed is in the next content
-        // In such case start at element index 0.
-        // If currentContentElementNb == 0, means not initialized, so skip
-        if ((nextElementIdx >= genericContext.currentContentElementNb)
-            && (genericContext.currentContentElementNb > 0)) {
-            nextContentIdx += 1;
-            nextElementIdx = 0;
-        }
-    }
-
-    // Handle backward navigation:
-    // add to current index the number of pairs of the currently active page
-    if (pageIdx < navInfo.activePage) {
-        // Backward navigation: remove to current index the number of pairs of the current page
-        nextElementIdx -= nbElementsInNextPage;
-
-        // Handle case where the content to be displayed is in the previous content
-        // In such case set a negative number as element index so that it is handled
-        // later once the previous content is accessible so that its elements number
-        // can be retrieved.
-        if (nextElementIdx < 0) {
-            nextContentIdx -= 1;
-            nextElementIdx = -nbElementsInNextPage;
-        }
-    }
+    genericContextGetPageInfo(pageIdx, p_nbElementsInNextPage, p_flag);
 
     const nbgl_content_t *p_content;
     // Retrieve next content
@@ -1001,15 +1003,11 @@ static const nbgl_content_t *genericContextComputeNextPageParams(uint8_t
     // - Update genericContext.currentContentIdx
     // - Update genericContext.currentContentElementNb
     // - Update onContentAction callback
-    // - Update nextElementIdx in case it was previously not calculable
     if ((nextContentIdx != genericContext.currentContentIdx)
         || (genericContext.currentContentElementNb == 0)) {
         genericContext.currentContentIdx       = nextContentIdx;
         genericContext.currentContentElementNb = getContentNbElement(p_content);
         onContentAction                        = PIC(p_content->contentActionCallback);
-        if (nextElementIdx < 0) {
-            nextElementIdx = genericContext.currentContentElementNb + nextElementIdx;
-        }
     }
 
     // Sanity check
@@ -1267,7 +1265,12 @@ static void displayGenericContextPage(uint8_t pageIdx, bool forceFullRefresh)
             }
             return;
         }
-        else if (pageIdx >= bundleNavContext.reviewStreaming.stepPageNb) {
+        // paginate the step up to the requested page, if not done yet
+        while ((pageIdx >= bundleNavContext.reviewStreaming.stepPageNb)
+               && !bundleNavContext.reviewStreaming.isPaginated) {
+            streamingPaginateNextPage();
+        }
+        if (pageIdx >= bundleNavContext.reviewStreaming.stepPageNb) {
             bundleNavReviewStreamingChoice(true);
             return;
         }
@@ -1279,26 +1282,8 @@ static void displayGenericContextPage(uint8_t pageIdx, bool forceFullRefresh)
         }
     }
 
-    if (navInfo.activePage == pageIdx) {
-        p_content
-            = genericContextComputeNextPageParams(pageIdx, &content, &nbElementsInPage, &flag);
-    }
-    else if (navInfo.activePage < pageIdx) {
-        // Support going more than one step forward.
-        // It occurs when initializing a navigation on an arbitrary page
-        for (int i = navInfo.activePage + 1; i <= pageIdx; i++) {
-            p_content = genericContextComputeNextPageParams(i, &content, &nbElementsInPage, &flag);
-        }
-    }
-    else {
-        if (pageIdx - navInfo.activePage > 1) {
-            // We don't support going more than one step backward as it doesn't occurs for now?
-            LOG_DEBUG(USE_CASE_LOGGER, "Unsupported navigation\n");
-            return;
-        }
-        p_content
-            = genericContextComputeNextPageParams(pageIdx, &content, &nbElementsInPage, &flag);
-    }
+    // Any page can be reached directly, thanks to the pagination index
+    p_content = genericContextComputeNextPageParams(pageIdx, &content, &nbElementsInPage, &flag);
 
     if (p_content == NULL) {
         return;
@@ -1340,7 +1325,7 @@ static const char *getDetailsPageAt(uint8_t detailsPage)
     const char *currentChar = detailsContext.value;
     while (page < detailsPage) {
         uint16_t nbLines
-            = nbgl_getTextNbLinesInWidth(SMALL_BOLD_FONT, currentChar, AVAILABLE_WIDTH, false);
+            = layoutGetTextNbLinesInWidth(SMALL_BOLD_FONT, currentChar, AVAILABLE_WIDTH, false);
         if (nbLines > NB_MAX_LINES_IN_DETAILS) {
             uint16_t len;
             nbgl_getTextMaxLenInNbLines(SMALL_BOLD_FONT,
@@ -1399,7 +1384,7 @@ static void displayDetailsPage(uint8_t detailsPage, bool forceFullRefresh)
         currentPair.value = detailsContext.nextPageStart;
     }
     detailsContext.currentPage = detailsPage;
-    uint16_t nbLines           = nbgl_getTextNbLinesInWidth(
+    uint16_t nbLines           = layoutGetTextNbLinesInWidth(
         SMALL_BOLD_FONT, currentPair.value, AVAILABLE_WIDTH, detailsContext.wrapping);
 
     if (nbLines > NB_MAX_LINES_IN_DETAILS) {
@@ -1624,10 +1609,11 @@ static void displayAddressQRCode(void)
     // add empty header for better look
     nbgl_layoutAddHeader(addressConfirmationContext.modalLayout, &headerDesc);
     // compute nb lines to check whether it shall be shorten (max is 3 lines)
-    uint16_t nbLines = nbgl_getTextNbLinesInWidth(SMALL_REGULAR_FONT,
-                                                  addressConfirmationContext.tagValuePairs[0].value,
-                                                  AVAILABLE_WIDTH,
-                                                  false);
+    uint16_t nbLines
+        = layoutGetTextNbLinesInWidth(SMALL_REGULAR_FONT,
+                                      addressConfirmationContext.tagValuePairs[0].value,
+                                      AVAILABLE_WIDTH,
+                                      false);
 
     if (nbLines <= QRCODE_NB_MAX_LINES) {
         qrCode.text2 = addressConfirmationContext.tagValuePairs[0].value;  // in gray
@@ -2038,6 +2024,8 @@ static void keyboardGeneric_cb(int token, uint8_t index)
  * @param requireSpecificDisplay (output) set to true if the tag/value needs a specific display:
  *        - centeredInfo flag is enabled
  *        - the tag/value doesn't fit in a page
+ * @param measure (input/output) if not NULL, last pair measured in the previous page of the same
+ *        list, so that it is not fetched and measured again
  * @return the number of tag/value pairs fitting in a page
  */
 static uint8_t getNbTagValuesInPage(uint8_t                           nbPairs,
@@ -2046,7 +2034,8 @@ static uint8_t getNbTagValuesInPage(uint8_t                           nbPairs,
                                     bool                              isSkippable,
                                     bool                              hasConfirmationButton,
                                     bool                              hasDetailsButton,
-                                    bool                             *requireSpecificDisplay)
+                                    bool                             *requireSpecificDisplay,
+                                    TagValueMeasure_t                *measure)
 {
     uint8_t  nbPairsInPage   = 0;
     uint16_t currentHeight   = PRE_TAG_VALUE_MARGIN;  // upper margin
@@ -2063,14 +2052,23 @@ static uint8_t getNbTagValuesInPage(uint8_t                           nbPairs,
         const nbgl_layoutTagValue_t *pair;
         nbgl_font_id_e               value_font;
         uint16_t                     nbLines;
+        uint16_t                     pairHeight;
+        bool                         measured = false;
 
         // margin between pairs
         // 12 or 24 px between each tag/value pair
         if (nbPairsInPage > 0) {
             currentHeight += INTER_TAG_VALUE_MARGIN;
         }
-        // fetch tag/value pair strings.
-        if (tagValueList->pairs != NULL) {
+        // fetch tag/value pair strings, unless it has just been done for the previous page
+        if ((measure != NULL) && (measure->pair != NULL)
+            && (measure->index == startIndex + nbPairsInPage)) {
+            pair       = measure->pair;
+            pairHeight = measure->height;
+            nbLines    = measure->nbLines;
+            measured   = true;
+        }
+        else if (tagValueList->pairs != NULL) {
             pair = PIC(&tagValueList->pairs[startIndex + nbPairsInPage]);
         }
         else {
@@ -2095,49 +2093,58 @@ static uint8_t getNbTagValuesInPage(uint8_t                           nbPairs,
             }
         }
 
-        // tag height
-        currentHeight += nbgl_getTextHeightInWidth(
-            SMALL_REGULAR_FONT, pair->item, AVAILABLE_WIDTH, tagValueList->wrapping);
-        // space between tag and value
-        currentHeight += TAG_VALUE_INTERVALE;
-        // set value font
-        if (tagValueList->smallCaseForValue) {
-            value_font = SMALL_REGULAR_FONT;
-        }
-        else {
-            value_font = LARGE_MEDIUM_FONT;
-        }
-        // nb lines for value
-        nbLines = nbgl_getTextNbLinesInWidth(
-            value_font, pair->value, AVAILABLE_WIDTH, tagValueList->wrapping);
-        // honor list-level nbMaxLinesForValue: when set, the value will be
-        // displayed truncated to that many lines, so account for its
-        // truncated height rather than its full height.
-        // Caveat: review TAG_VALUE_LIST/TAG_VALUE_DETAILS pages always render
-        // up to NB_MAX_LINES_IN_REVIEW lines, because the display path forces
-        // nbMaxLinesForValue back to NB_MAX_LINES_IN_REVIEW (see
-        // genericContextPreparePageContent / displayReviewPage). So a list-level
-        // value smaller than NB_MAX_LINES_IN_REVIEW must NOT shorten the height
-        // estimate here, otherwise the page gets under-allocated and content is
-        // drawn off-screen. Only honor a value that the display will actually
-        // apply (i.e. >= NB_MAX_LINES_IN_REVIEW).
-        uint8_t effectiveMaxLines = tagValueList->nbMaxLinesForValue;
-        if ((effectiveMaxLines > 0) && (effectiveMaxLines < NB_MAX_LINES_IN_REVIEW)) {
-            effectiveMaxLines = 0;
-        }
-        if ((effectiveMaxLines > 0) && (nbLines > effectiveMaxLines)) {
-            nbLines = effectiveMaxLines;
-            currentHeight += nbLines * nbgl_getFontLineHeight(value_font);
-        }
-        else {
-            currentHeight += nbgl_getTextHeightInWidth(
+        if (!measured) {
+            // tag height
+            pairHeight = layoutGetTextHeightInWidth(
+                SMALL_REGULAR_FONT, pair->item, AVAILABLE_WIDTH, tagValueList->wrapping);
+            // space between tag and value
+            pairHeight += TAG_VALUE_INTERVALE;
+            // set value font
+            if (tagValueList->smallCaseForValue) {
+                value_font = SMALL_REGULAR_FONT;
+            }
+            else {
+                value_font = LARGE_MEDIUM_FONT;
+            }
+            // nb lines for value
+            nbLines = layoutGetTextNbLinesInWidth(
                 value_font, pair->value, AVAILABLE_WIDTH, tagValueList->wrapping);
-        }
+            // honor list-level nbMaxLinesForValue: when set, the value will be
+            // displayed truncated to that many lines, so account for its
+            // truncated height rather than its full height.
+            // Caveat: review TAG_VALUE_LIST/TAG_VALUE_DETAILS pages always render
+            // up to NB_MAX_LINES_IN_REVIEW lines, because the display path forces
+            // nbMaxLinesForValue back to NB_MAX_LINES_IN_REVIEW (see
+            // genericContextPreparePageContent / displayReviewPage). So a list-level
+            // value smaller than NB_MAX_LINES_IN_REVIEW must NOT shorten the height
+            // estimate here, otherwise the page gets under-allocated and content is
+            // drawn off-screen. Only honor a value that the display will actually
+            // apply (i.e. >= NB_MAX_LINES_IN_REVIEW).
+            uint8_t effectiveMaxLines = tagValueList->nbMaxLinesForValue;
+            if ((effectiveMaxLines > 0) && (effectiveMaxLines < NB_MAX_LINES_IN_REVIEW)) {
+                effectiveMaxLines = 0;
+            }
+            if ((effectiveMaxLines > 0) && (nbLines > effectiveMaxLines)) {
+                nbLines = effectiveMaxLines;
+                pairHeight += nbLines * nbgl_getFontLineHeight(value_font);
+            }
+            else {
+                pairHeight += layoutGetTextHeightInWidth(
+                    value_font, pair->value, AVAILABLE_WIDTH, tagValueList->wrapping);
+            }
 
-        // potential subAlias text
-        if ((pair->aliasValue) && (pair->extension->aliasSubName)) {
-            currentHeight += TAG_VALUE_INTERVALE + nbgl_getFontLineHeight(SMALL_REGULAR_FONT);
+            // potential subAlias text
+            if ((pair->aliasValue) && (pair->extension->aliasSubName)) {
+                pairHeight += TAG_VALUE_INTERVALE + nbgl_getFontLineHeight(SMALL_REGULAR_FONT);
+            }
+            if (measure != NULL) {
+                measure->pair    = pair;
+                measure->height  = pairHeight;
+                measure->nbLines = nbLines;
+                measure->index   = startIndex + nbPairsInPage;
+            }
         }
+        currentHeight += pairHeight;
         if ((currentHeight >= maxUsableHeight) || (nbLines > NB_MAX_LINES_IN_REVIEW)) {
             if (nbPairsInPage == 0) {
                 // Pair too long to fit in a single screen
@@ -2204,13 +2211,13 @@ static uint8_t getNbTagValuesInDetailsPage(uint8_t                           nbP
         }
 
         // tag height
-        currentHeight += nbgl_getTextHeightInWidth(
+        currentHeight += layoutGetTextHeightInWidth(
             SMALL_REGULAR_FONT, pair->item, AVAILABLE_WIDTH, tagValueList->wrapping);
         // space between tag and value
         currentHeight += 4;
 
         // value height
-        currentHeight += nbgl_getTextHeightInWidth(
+        currentHeight += layoutGetTextHeightInWidth(
             SMALL_REGULAR_FONT, pair->value, AVAILABLE_WIDTH, tagValueList->wrapping);
 
         // we have reached the maximum height, it means than there are to many pairs
@@ -2222,63 +2229,78 @@ static uint8_t getNbTagValuesInDetailsPage(uint8_t                           nbP
     return nbPairsInPage;
 }
 
+// returns the number of elements of the given content fitting in the page starting at elemIdx
+static uint8_t getNbElementsInPage(const nbgl_content_t *content,
+                                   uint8_t               nbElements,
+                                   uint8_t               elemIdx,
+                                   bool                  hasNav,
+                                   bool                  isLast,
+                                   bool                  isSkippable,
+                                   bool                 *flag,
+                                   TagValueMeasure_t    *measure)
+{
+    *flag = false;
+    if (content->type == TAG_VALUE_LIST) {
+        return getNbTagValuesInPage(nbElements,
+                                    &content->content.tagValueList,
+                                    elemIdx,
+                                    isSkippable,
+                                    false,
+                                    false,
+                                    flag,
+                                    measure);
+    }
+    else if (content->type == TAG_VALUE_CONFIRM) {
+        return getNbTagValuesInPage(nbElements,
+                                    &content->content.tagValueConfirm.tagValueList,
+                                    elemIdx,
+                                    isSkippable,
+                                    isLast,
+                                    !isLast,
+                                    flag,
+                                    measure);
+    }
+    else if (content->type == INFOS_LIST) {
+        return nbgl_useCaseGetNbInfosInPage(
+            nbElements, &content->content.infosList, elemIdx, hasNav);
+    }
+    else if (content->type == SWITCHES_LIST) {
+        return nbgl_useCaseGetNbSwitchesInPage(
+            nbElements, &content->content.switchesList, elemIdx, hasNav);
+    }
+    else if (content->type == BARS_LIST) {
+        return nbgl_useCaseGetNbBarsInPage(nbElements, &content->content.barsList, elemIdx, hasNav);
+    }
+    else if (content->type == CHOICES_LIST) {
+        return nbgl_useCaseGetNbChoicesInPage(
+            nbElements, &content->content.choicesList, elemIdx, hasNav);
+    }
+    return MIN(nbMaxElementsPerContentType[content->type], nbElements);
+}
+
 static uint8_t getNbPagesForContent(const nbgl_content_t *content,
+                                    int8_t                contentIdx,
                                     uint8_t               pageIdxStart,
                                     bool                  isLast,
                                     bool                  isSkippable)
 {
-    uint8_t nbElements = 0;
-    uint8_t nbPages    = 0;
-    uint8_t nbElementsInPage;
-    uint8_t elemIdx = 0;
-    bool    flag;
+    uint8_t           nbElements = 0;
+    uint8_t           nbPages    = 0;
+    uint8_t           nbElementsInPage;
+    uint8_t           elemIdx = 0;
+    bool              flag;
+    TagValueMeasure_t measure = {0};
 
     nbElements = getContentNbElement(content);
 
     while (nbElements > 0) {
-        flag = 0;
         // if the current page is not the first one (or last), a navigation bar exists
-        bool hasNav = !isLast || (pageIdxStart > 0) || (elemIdx > 0);
-        if (content->type == TAG_VALUE_LIST) {
-            nbElementsInPage = getNbTagValuesInPage(nbElements,
-                                                    &content->content.tagValueList,
-                                                    elemIdx,
-                                                    isSkippable,
-                                                    false,
-                                                    false,
-                                                    &flag);
-        }
-        else if (content->type == TAG_VALUE_CONFIRM) {
-            nbElementsInPage = getNbTagValuesInPage(nbElements,
-                                                    &content->content.tagValueConfirm.tagValueList,
-                                                    elemIdx,
-                                                    isSkippable,
-                                                    isLast,
-                                                    !isLast,
-                                                    &flag);
-        }
-        else if (content->type == INFOS_LIST) {
-            nbElementsInPage = nbgl_useCaseGetNbInfosInPage(
-                nbElements, &content->content.infosList, elemIdx, hasNav);
-        }
-        else if (content->type == SWITCHES_LIST) {
-            nbElementsInPage = nbgl_useCaseGetNbSwitchesInPage(
-                nbElements, &content->content.switchesList, elemIdx, hasNav);
-        }
-        else if (content->type == BARS_LIST) {
-            nbElementsInPage = nbgl_useCaseGetNbBarsInPage(
-                nbElements, &content->content.barsList, elemIdx, hasNav);
-        }
-        else if (content->type == CHOICES_LIST) {
-            nbElementsInPage = nbgl_useCaseGetNbChoicesInPage(
-                nbElements, &content->content.choicesList, elemIdx, hasNav);
-        }
-        else {
-            nbElementsInPage = MIN(nbMaxElementsPerContentType[content->type], nbElements);
-        }
+        bool hasNav      = !isLast || (pageIdxStart > 0) || (elemIdx > 0);
+        nbElementsInPage = getNbElementsInPage(
+            content, nbElements, elemIdx, hasNav, isLast, isSkippable, &flag, &measure);
 
+        genericContextSetPageInfo(pageIdxStart + nbPages, contentIdx, nbElementsInPage, flag);
         elemIdx += nbElementsInPage;
-        genericContextSetPageInfo(pageIdxStart + nbPages, nbElementsInPage, flag);
         nbElements -= nbElementsInPage;
         nbPages++;
     }
@@ -2286,6 +2308,38 @@ static uint8_t getNbPagesForContent(const nbgl_content_t *content,
     return nbPages;
 }
 
+// paginates the next page of the current step of a streaming review, if any. The pairs of the
+// step are only retrieved (and measured) when their page is about to be reached.
+// The last measured pair is not reused from a page to the next one, because a pair retrieved
+// with a callback may have been overwritten by the display of the page in between.
+static void streamingPaginateNextPage(void)
+{
+    nbgl_reviewStreamingContext_t *streaming = &bundleNavContext.reviewStreaming;
+    uint8_t                        nbElements;
+    uint8_t                        nbElementsInPage;
+    bool                           flag;
+
+    if (streaming->isPaginated) {
+        return;
+    }
+    nbElements = getContentNbElement(&STARTING_CONTENT) - streaming->nextElementIdx;
+    if (nbElements > 0) {
+        nbElementsInPage = getNbElementsInPage(&STARTING_CONTENT,
+                                               nbElements,
+                                               streaming->nextElementIdx,
+                                               true,
+                                               true,
+                                               (streaming->operationType & SKIPPABLE_OPERATION),
+                                               &flag,
+                                               NULL);
+        genericContextSetPageInfo(streaming->stepPageNb, 0, nbElementsInPage, flag);
+        streaming->nextElementIdx += nbElementsInPage;
+        nbElements -= nbElementsInPage;
+        streaming->stepPageNb++;
+    }
+    streaming->isPaginated = (nbElements == 0);
+}
+
 static uint8_t getNbPagesForGenericContents(const nbgl_genericContents_t *genericContents,
                                             uint8_t                       pageIdxStart,
                                             bool                          isSkippable)
@@ -2300,6 +2354,7 @@ static uint8_t getNbPagesForGenericContents(const nbgl_genericContents_t *generi
             return 0;
         }
         nbPages += getNbPagesForContent(p_content,
+                                        i,
                                         pageIdxStart + nbPages,
                                         (i == (genericContents->nbContents - 1)),
                                         isSkippable);
@@ -2372,7 +2427,7 @@ static void prepareAddressConfirmationPages(const char                       *ad
         tmpList.nbPairs                    = addressConfirmationContext.nbPairs;
         tmpList.pairs                      = addressConfirmationContext.tagValuePairs;
         addressConfirmationContext.nbPairs = getNbTagValuesInPage(
-            addressConfirmationContext.nbPairs, &tmpList, 0, false, true, true, &flag);
+            addressConfirmationContext.nbPairs, &tmpList, 0, false, true, true, &flag, NULL);
         // if they don't all fit, keep only the address
         if (tmpList.nbPairs > addressConfirmationContext.nbPairs) {
             addressConfirmationContext.nbPairs = 1;
@@ -3031,6 +3086,7 @@ static void useCaseReviewStreamingStart(nbgl_operationType_t       operationType
     // compute number of pages & fill navigation structure
     bundleNavContext.reviewStreaming.stepPageNb = getNbPagesForGenericContents(
         &genericContext.genericContents, 0, (operationType & SKIPPABLE_OPERATION));
+    bundleNavContext.reviewStreaming.isPaginated = true;
     prepareNavInfo(true, NBGL_NO_PROGRESS_INDICATOR, getRejectReviewText(operationType));
     // no back button on first page
     navInfo.navWithButtons.backButton = false;
@@ -3114,7 +3170,8 @@ static void useCaseHomeExt(const char                *appName,
 
         // If there is more than 3 lines, it means the appName was split, so we put it on the next
         // line
-        if (nbgl_getTextNbLinesInWidth(SMALL_REGULAR_FONT, tmpString, AVAILABLE_WIDTH, false) > 3) {
+        if (layoutGetTextNbLinesInWidth(SMALL_REGULAR_FONT, tmpString, AVAILABLE_WIDTH, false)
+            > 3) {
             snprintf(tmpString,
                      APP_DESCRIPTION_MAX_LEN,
                      "%s\n%s %s",
@@ -3148,7 +3205,7 @@ static void displayDetails(const char *tag, const char *value, bool wrapping)
     memset(&detailsContext, 0, sizeof(detailsContext));
 
     uint16_t nbLines
-        = nbgl_getTextNbLinesInWidth(SMALL_REGULAR_FONT, value, AVAILABLE_WIDTH, wrapping);
+        = layoutGetTextNbLinesInWidth(SMALL_REGULAR_FONT, value, AVAILABLE_WIDTH, wrapping);
 
     // initialize context
     detailsContext.tag         = tag;
@@ -3225,7 +3282,7 @@ uint8_t nbgl_useCaseGetNbTagValuesInPage(uint8_t                           nbPai
                                          bool                             *requireSpecificDisplay)
 {
     return getNbTagValuesInPage(
-        nbPairs, tagValueList, startIndex, false, false, false, requireSpecificDisplay);
+        nbPairs, tagValueList, startIndex, false, false, false, requireSpecificDisplay, NULL);
 }
 
 /**
@@ -3247,8 +3304,14 @@ uint8_t nbgl_useCaseGetNbTagValuesInPageExt(uint8_t                           nb
                                             bool                              isSkippable,
                                             bool *requireSpecificDisplay)
 {
-    return getNbTagValuesInPage(
-        nbPairs, tagValueList, startIndex, isSkippable, false, false, requireSpecificDisplay);
+    return getNbTagValuesInPage(nbPairs,
+                                tagValueList,
+                                startIndex,
+                                isSkippable,
+                                false,
+                                false,
+                                requireSpecificDisplay,
+                                NULL);
 }
 
 /**
@@ -3277,10 +3340,10 @@ uint8_t nbgl_useCaseGetNbInfosInPage(uint8_t                       nbInfos,
             += LIST_ITEM_MIN_TEXT_HEIGHT + 2 * LIST_ITEM_PRE_HEADING + LIST_ITEM_HEADING_SUB_TEXT;
 
         // content height
-        currentHeight += nbgl_getTextHeightInWidth(SMALL_REGULAR_FONT,
-                                                   PIC(infoContents[startIndex + nbInfosInPage]),
-                                                   AVAILABLE_WIDTH,
-                                                   true);
+        currentHeight += layoutGetTextHeightInWidth(SMALL_REGULAR_FONT,
+                                                    PIC(infoContents[startIndex + nbInfosInPage]),
+                                                    AVAILABLE_WIDTH,
+                                                    true);
         // if height is over the limit
         if (currentHeight >= (INFOS_AREA_HEIGHT - navHeight)) {
             // if there was no nav, now there will be, so it can be necessary to remove the last
@@ -3322,14 +3385,14 @@ uint8_t nbgl_useCaseGetNbSwitchesInPage(uint8_t                           nbSwit
         // or we use its height directly
         uint16_t textHeight = MAX(
             LIST_ITEM_MIN_TEXT_HEIGHT,
-            nbgl_getTextHeightInWidth(SMALL_BOLD_FONT, curSwitch->text, AVAILABLE_WIDTH, true));
+            layoutGetTextHeightInWidth(SMALL_BOLD_FONT, curSwitch->text, AVAILABLE_WIDTH, true));
         currentHeight += textHeight + 2 * LIST_ITEM_PRE_HEADING;
 
         if (curSwitch->subText) {
             currentHeight += LIST_ITEM_HEADING_SUB_TEXT;
 
             // sub-text height
-            currentHeight += nbgl_getTextHeightInWidth(
+            currentHeight += layoutGetTextHeightInWidth(
                 SMALL_REGULAR_FONT, curSwitch->subText, AVAILABLE_WIDTH, true);
         }
         // if height is over the limit
@@ -3578,7 +3641,11 @@ void nbgl_useCaseGenericSettings(const char                   *appName,
     // fill navigation structure
     uint8_t nbPages = getNbPagesForGenericContents(&genericContext.genericContents, 0, false);
     if (infosList != NULL) {
-        nbPages += getNbPagesForContent(&FINISHING_CONTENT, nbPages, true, false);
+        nbPages += getNbPagesForContent(&FINISHING_CONTENT,
+                                        genericContext.genericContents.nbContents,
+                                        nbPages,
+                                        true,
+                                        false);
     }
 
     prepareNavInfo(false, nbPages, NULL);
@@ -4508,6 +4575,10 @@ void nbgl_useCaseAdvancedReviewStreamingStart(nbgl_operationType_t       operati
  *        by others calls to nbgl_useCaseReviewStreamingContinue and finally to
  *        nbgl_useCaseReviewStreamingFinish.
  *
+ * @note  If tagValueList->pairs is NULL, tagValueList->callback is only called to retrieve the
+ *        pairs of a page when this page is about to be displayed, so the first page of the step
+ *        is displayed sooner.
+ *
  * @param tagValueList list of tag/value pairs
  * @param choiceCallback callback called when more operation data are needed (param is true) or
  * operation is rejected (param is false)
@@ -4539,11 +4610,11 @@ void nbgl_useCaseReviewStreamingContinueExt(const nbgl_contentTagValueList_t *ta
     memcpy(
         &STARTING_CONTENT.content.tagValueList, tagValueList, sizeof(nbgl_contentTagValueList_t));
 
-    // compute number of pages & fill navigation structure
-    bundleNavContext.reviewStreaming.stepPageNb = getNbPagesForGenericContents(
-        &genericContext.genericContents,
-        0,
-        (bundleNavContext.reviewStreaming.operationType & SKIPPABLE_OPERATION));
+    // the pages are paginated only when about to be reached, the first one being displayed
+    // right now
+    bundleNavContext.reviewStreaming.stepPageNb     = 0;
+    bundleNavContext.reviewStreaming.nextElementIdx = 0;
+    bundleNavContext.reviewStreaming.isPaginated    = false;
     prepareNavInfo(true,
                    NBGL_NO_PROGRESS_INDICATOR,
                    getRejectReviewText(bundleNavContext.reviewStreaming.operationType));
@@ -4610,6 +4681,7 @@ void nbgl_useCaseReviewStreamingFinish(const char           *finishTitle,
         &genericContext.genericContents,
         0,
         (bundleNavContext.reviewStreaming.operationType & SKIPPABLE_OPERATION));
+    bundleNavContext.reviewStreaming.isPaginated = true;
     prepareNavInfo(true, 1, getRejectReviewText(bundleNavContext.reviewStreaming.operationType));
 
     displayGenericContextPage(0, true);
@@ -21,6 +21,31 @@
 
 #include "base58.h"
 
+/*
+ * The numbers are stored in limbs, least significant first, so that each step of the conversion
+ * handles several digits:
+ * - when encoding, the limbs hold BASE58_LIMB_DIGITS base 58 digits each, and the input bytes are
+ *   added BASE58_STEP_BYTES at a time. Divisions by the constant BASE58_LIMB_BASE are turned into
+ *   multiplications by its reciprocal by the compiler, as long as they fit in a native word: 64-bit
+ *   hosts use 5 digits and 4 bytes per step, 32-bit targets 4 digits and 1 byte per step.
+ * - when decoding, the limbs hold 32 bits each, and the input characters are added 5 at a time,
+ *   with a 32x32->64 multiplication by 58^5 and no division at all.
+ */
+#if (UINTPTR_MAX > UINT32_MAX) && !defined(BASE58_NARROW_LIMBS)
+typedef uint64_t base58_acc_t;
+#define BASE58_LIMB_DIGITS 5
+#define BASE58_LIMB_BASE   656356768U  // 58^5
+#define BASE58_STEP_BYTES  4
+#else
+typedef uint32_t base58_acc_t;
+#define BASE58_LIMB_DIGITS 4
+#define BASE58_LIMB_BASE   11316496U  // 58^4
+#define BASE58_STEP_BYTES  1
+#endif
+
+// Number of digits added to the limbs at each decoding step
+#define BASE58_DECODE_STEP_DIGITS 5
+
 uint8_t const BASE58_TABLE[] = {
     0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
     0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
@@ -42,116 +67,217 @@ char const BASE58_ALPHABET[] = {
     'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z'             //
 };
 
-int base58_decode(const char *in, size_t in_len, uint8_t *out, size_t out_len)
+static const uint32_t BASE58_POWERS[BASE58_DECODE_STEP_DIGITS + 1]
+    = {1, 58, 3364, 195112, 11316496, 656356768};
+
+// limbs = limbs * 256^nb_bytes + value
+static bool encoder_push(base58_encoder_t *ctx, uint32_t value, uint8_t nb_bytes)
 {
-    uint8_t tmp[MAX_DEC_INPUT_SIZE]    = {0};
-    uint8_t buffer[MAX_DEC_INPUT_SIZE] = {0};
-    uint8_t j;
-    uint8_t start_at;
-    uint8_t zero_count = 0;
+    base58_acc_t carry = value;
 
-    if (in_len > MAX_DEC_INPUT_SIZE || in_len < 2) {
-        return -1;
+    for (size_t i = 0; i < ctx->nb_limbs; i++) {
+        base58_acc_t acc = ((base58_acc_t) ctx->limbs[i] << (8 * nb_bytes)) + carry;
+        ctx->limbs[i]    = (uint32_t) (acc % BASE58_LIMB_BASE);
+        carry            = acc / BASE58_LIMB_BASE;
     }
-
-    memmove(tmp, in, in_len);
-
-    for (uint8_t i = 0; i < in_len; i++) {
-        if (in[i] >= sizeof(BASE58_TABLE)) {
-            return -1;
+    while (carry != 0) {
+        if (ctx->nb_limbs == ctx->max_limbs) {
+            ctx->error = true;
+            return false;
         }
+        ctx->limbs[ctx->nb_limbs++] = (uint32_t) (carry % BASE58_LIMB_BASE);
+        carry /= BASE58_LIMB_BASE;
+    }
+    return true;
+}
 
-        tmp[i] = BASE58_TABLE[(int) in[i]];
+// limbs = limbs * multiplier + value
+static bool decoder_push(base58_decoder_t *ctx, uint32_t value, uint32_t multiplier)
+{
+    uint64_t carry = value;
 
-        if (tmp[i] == 0xFF) {
-            return -1;
+    for (size_t i = 0; i < ctx->nb_limbs; i++) {
+        uint64_t acc  = (uint64_t) ctx->limbs[i] * multiplier + carry;
+        ctx->limbs[i] = (uint32_t) acc;
+        carry         = acc >> 32;
+    }
+    if (carry != 0) {
+        if (ctx->nb_limbs == ctx->max_limbs) {
+            ctx->error = true;
+            return false;
         }
+        ctx->limbs[ctx->nb_limbs++] = (uint32_t) carry;
     }
+    return true;
+}
 
-    while ((zero_count < in_len) && (tmp[zero_count] == 0)) {
-        ++zero_count;
-    }
+void base58_encode_init(base58_encoder_t *ctx, uint32_t *work, size_t nb_limbs)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->limbs     = work;
+    ctx->max_limbs = nb_limbs;
+    ctx->leading   = true;
+}
 
-    j        = in_len;
-    start_at = zero_count;
-    while (start_at < in_len) {
-        uint16_t remainder = 0;
-        for (uint8_t div_loop = start_at; div_loop < in_len; div_loop++) {
-            uint16_t digit256 = (uint16_t) (tmp[div_loop] & 0xFF);
-            uint16_t tmp_div  = remainder * 58 + digit256;
-            tmp[div_loop]     = (uint8_t) (tmp_div / 256);
-            remainder         = tmp_div % 256;
+bool base58_encode_update(base58_encoder_t *ctx, const uint8_t *in, size_t in_len)
+{
+    for (size_t i = 0; (i < in_len) && !ctx->error; i++) {
+        if (ctx->leading && (in[i] == 0)) {
+            ctx->zero_count++;
+            continue;
         }
-
-        if (tmp[start_at] == 0) {
-            ++start_at;
+        ctx->leading = false;
+        ctx->pending = (ctx->pending << 8) | in[i];
+        if (++ctx->nb_pending == BASE58_STEP_BYTES) {
+            encoder_push(ctx, ctx->pending, ctx->nb_pending);
+            ctx->pending    = 0;
+            ctx->nb_pending = 0;
         }
+    }
+    return !ctx->error;
+}
+
+int base58_encode_final(base58_encoder_t *ctx, char *out, size_t out_len)
+{
+    size_t top_digits = 0;
+    size_t length;
+    char  *digit;
 
-        buffer[--j] = (uint8_t) remainder;
+    if ((ctx->nb_pending != 0) && !ctx->error) {
+        encoder_push(ctx, ctx->pending, ctx->nb_pending);
+        ctx->nb_pending = 0;
+    }
+    if (ctx->error) {
+        return -1;
     }
 
-    while ((j < in_len) && (buffer[j] == 0)) {
-        ++j;
+    // the most significant limb is not zero, only its significant digits are written
+    if (ctx->nb_limbs != 0) {
+        for (uint32_t value = ctx->limbs[ctx->nb_limbs - 1]; value != 0; value /= 58) {
+            top_digits++;
+        }
+    }
+    length = ctx->zero_count;
+    if (ctx->nb_limbs != 0) {
+        length += (ctx->nb_limbs - 1) * BASE58_LIMB_DIGITS + top_digits;
+    }
+    if ((out_len < length) || (length > INT32_MAX)) {
+        return -1;
     }
 
-    int length = in_len - (j - zero_count);
+    memset(out, BASE58_ALPHABET[0], ctx->zero_count);
+    digit = out + length;
+    for (size_t i = 0; i < ctx->nb_limbs; i++) {
+        uint32_t value     = ctx->limbs[i];
+        size_t   nb_digits = (i == ctx->nb_limbs - 1) ? top_digits : BASE58_LIMB_DIGITS;
 
-    if ((int) out_len < length) {
-        return -1;
+        for (size_t j = 0; j < nb_digits; j++) {
+            *--digit = BASE58_ALPHABET[value % 58];
+            value /= 58;
+        }
     }
 
-    memmove(out, buffer + j - zero_count, length);
+    return (int) length;
+}
 
-    return length;
+void base58_decode_init(base58_decoder_t *ctx, uint32_t *work, size_t nb_limbs)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->limbs     = work;
+    ctx->max_limbs = nb_limbs;
+    ctx->leading   = true;
 }
 
-int base58_encode(const uint8_t *in, size_t in_len, char *out, size_t out_len)
+bool base58_decode_update(base58_decoder_t *ctx, const char *in, size_t in_len)
 {
-    uint8_t buffer[MAX_ENC_INPUT_SIZE * 138 / 100 + 1] = {0};
-    size_t  i, j;
-    size_t  stop_at;
-    size_t  zero_count = 0;
-    size_t  output_size;
+    for (size_t i = 0; (i < in_len) && !ctx->error; i++) {
+        uint8_t c = (uint8_t) in[i];
 
-    if (in_len > MAX_ENC_INPUT_SIZE) {
+        if ((c >= sizeof(BASE58_TABLE)) || (BASE58_TABLE[c] == 0xFF)) {
+            ctx->error = true;
+            break;
+        }
+        if (ctx->leading && (BASE58_TABLE[c] == 0)) {
+            ctx->zero_count++;
+            continue;
+        }
+        ctx->leading = false;
+        ctx->pending = ctx->pending * 58 + BASE58_TABLE[c];
+        if (++ctx->nb_pending == BASE58_DECODE_STEP_DIGITS) {
+            decoder_push(ctx, ctx->pending, BASE58_POWERS[BASE58_DECODE_STEP_DIGITS]);
+            ctx->pending    = 0;
+            ctx->nb_pending = 0;
+        }
+    }
+    return !ctx->error;
+}
+
+int base58_decode_final(base58_decoder_t *ctx, uint8_t *out, size_t out_len)
+{
+    size_t top_bytes = 0;
+    size_t length;
+
+    if ((ctx->nb_pending != 0) && !ctx->error) {
+        decoder_push(ctx, ctx->pending, BASE58_POWERS[ctx->nb_pending]);
+        ctx->nb_pending = 0;
+    }
+    if (ctx->error) {
         return -1;
     }
 
-    while ((zero_count < in_len) && (in[zero_count] == 0)) {
-        ++zero_count;
+    // the most significant limb is not zero, only its significant bytes are written
+    if (ctx->nb_limbs != 0) {
+        for (uint32_t value = ctx->limbs[ctx->nb_limbs - 1]; value != 0; value >>= 8) {
+            top_bytes++;
+        }
+    }
+    length = ctx->zero_count;
+    if (ctx->nb_limbs != 0) {
+        length += (ctx->nb_limbs - 1) * sizeof(uint32_t) + top_bytes;
+    }
+    if ((out_len < length) || (length > INT32_MAX)) {
+        return -1;
     }
 
-    output_size = (in_len - zero_count) * 138 / 100 + 1;
-    stop_at     = output_size - 1;
-    for (size_t start_at = zero_count; start_at < in_len; start_at++) {
-        int carry = in[start_at];
-        for (j = output_size - 1; (int) j >= 0; j--) {
-            carry += 256 * buffer[j];
-            buffer[j] = carry % 58;
-            carry /= 58;
+    memset(out, 0, ctx->zero_count);
+    out += length;
+    for (size_t i = 0; i < ctx->nb_limbs; i++) {
+        uint32_t value    = ctx->limbs[i];
+        size_t   nb_bytes = (i == ctx->nb_limbs - 1) ? top_bytes : sizeof(uint32_t);
 
-            if (j <= stop_at - 1 && carry == 0) {
-                break;
-            }
+        for (size_t j = 0; j < nb_bytes; j++) {
+            *--out = (uint8_t) value;
+            value >>= 8;
         }
-        stop_at = j;
     }
 
-    j = 0;
-    while (j < output_size && buffer[j] == 0) {
-        j += 1;
-    }
+    return (int) length;
+}
+
+int base58_decode(const char *in, size_t in_len, uint8_t *out, size_t out_len)
+{
+    uint32_t         work[BASE58_DECODE_WORK_LIMBS(MAX_DEC_INPUT_SIZE)];
+    base58_decoder_t ctx;
 
-    if (out_len < zero_count + output_size - j) {
+    if (in_len > MAX_DEC_INPUT_SIZE || in_len < 2) {
         return -1;
     }
 
-    memset(out, BASE58_ALPHABET[0], zero_count);
+    base58_decode_init(&ctx, work, BASE58_DECODE_WORK_LIMBS(in_len));
+    base58_decode_update(&ctx, in, in_len);
+    return base58_decode_final(&ctx, out, out_len);
+}
 
-    i = zero_count;
-    while (j < output_size) {
-        out[i++] = BASE58_ALPHABET[buffer[j++]];
+int base58_encode(const uint8_t *in, size_t in_len, char *out, size_t out_len)
+{
+    uint32_t         work[BASE58_ENCODE_WORK_LIMBS(MAX_ENC_INPUT_SIZE)];
+    base58_encoder_t ctx;
+
+    if (in_len > MAX_ENC_INPUT_SIZE) {
+        return -1;
     }
 
-    return i;
+    base58_encode_init(&ctx, work, BASE58_ENCODE_WORK_LIMBS(in_len));
+    base58_encode_update(&ctx, in, in_len);
+    return base58_encode_final(&ctx, out, out_len);
 }
@@ -13,6 +13,44 @@
  */
 #define MAX_ENC_INPUT_SIZE 120
 
+/**
+ * Number of limbs of the workspace needed to encode in_len bytes with a @ref base58_encoder_t.
+ */
+#define BASE58_ENCODE_WORK_LIMBS(in_len) (((in_len) * 138 / 100 + 1 + 3) / 4)
+/**
+ * Number of limbs of the workspace needed to decode in_len characters with a
+ * @ref base58_decoder_t.
+ */
+#define BASE58_DECODE_WORK_LIMBS(in_len) (((in_len) * 733 / 1000 + 1 + 3) / 4)
+
+/**
+ * Streaming base 58 encoder, see @ref base58_encode_init.
+ */
+typedef struct {
+    uint32_t *limbs;       ///< workspace, least significant limb first
+    size_t    max_limbs;   ///< number of limbs of the workspace
+    size_t    nb_limbs;    ///< number of limbs in use
+    size_t    zero_count;  ///< number of leading zero bytes
+    uint32_t  pending;     ///< bytes not yet added to the limbs
+    uint8_t   nb_pending;  ///< number of bytes in pending
+    bool      leading;     ///< true until the first non-zero byte
+    bool      error;       ///< true if the workspace is too small
+} base58_encoder_t;
+
+/**
+ * Streaming base 58 decoder, see @ref base58_decode_init.
+ */
+typedef struct {
+    uint32_t *limbs;       ///< workspace, least significant limb first
+    size_t    max_limbs;   ///< number of limbs of the workspace
+    size_t    nb_limbs;    ///< number of limbs in use
+    size_t    zero_count;  ///< number of leading '1' characters
+    uint32_t  pending;     ///< digits not yet added to the limbs
+    uint8_t   nb_pending;  ///< number of digits in pending
+    bool      leading;     ///< true until the first character other than '1'
+    bool      error;       ///< true on invalid character, or if the workspace is too small
+} base58_decoder_t;
+
 /**
  * Decode input string in base 58.
  *
@@ -50,3 +88,91 @@ int base58_decode(const char *in, size_t in_len, uint8_t *out, size_t out_len);
  *
  */
 int base58_encode(const uint8_t *in, size_t in_len, char *out, size_t out_len);
+
+/**
+ * Start a streaming base 58 encoding, for inputs longer than MAX_ENC_INPUT_SIZE or received in
+ * several parts.
+ *
+ * @param[out] ctx
+ *   Pointer to the encoder.
+ * @param[in]  work
+ *   Pointer to the workspace, of BASE58_ENCODE_WORK_LIMBS(total input length) limbs.
+ * @param[in]  nb_limbs
+ *   Number of limbs of the workspace.
+ *
+ */
+void base58_encode_init(base58_encoder_t *ctx, uint32_t *work, size_t nb_limbs);
+
+/**
+ * Add input bytes to a streaming base 58 encoding.
+ *
+ * @param[in,out] ctx
+ *   Pointer to the encoder.
+ * @param[in]     in
+ *   Pointer to the next input bytes.
+ * @param[in]     in_len
+ *   Number of input bytes.
+ *
+ * @return true if success, false if the workspace is too small.
+ *
+ */
+bool base58_encode_update(base58_encoder_t *ctx, const uint8_t *in, size_t in_len);
+
+/**
+ * Finish a streaming base 58 encoding and write the string.
+ *
+ * @param[in,out] ctx
+ *   Pointer to the encoder.
+ * @param[out]    out
+ *   Pointer to output string buffer.
+ * @param[in]     out_len
+ *   Maximum length to write in output string buffer.
+ *
+ * @return number of characters written, -1 otherwise.
+ *
+ */
+int base58_encode_final(base58_encoder_t *ctx, char *out, size_t out_len);
+
+/**
+ * Start a streaming base 58 decoding, for inputs longer than MAX_DEC_INPUT_SIZE or received in
+ * several parts.
+ *
+ * @param[out] ctx
+ *   Pointer to the decoder.
+ * @param[in]  work
+ *   Pointer to the workspace, of BASE58_DECODE_WORK_LIMBS(total input length) limbs.
+ * @param[in]  nb_limbs
+ *   Number of limbs of the workspace.
+ *
+ */
+void base58_decode_init(base58_decoder_t *ctx, uint32_t *work, size_t nb_limbs);
+
+/**
+ * Add input characters to a streaming base 58 decoding.
+ *
+ * @param[in,out] ctx
+ *   Pointer to the decoder.
+ * @param[in]     in
+ *   Pointer to the next input characters.
+ * @param[in]     in_len
+ *   Number of input characters.
+ *
+ * @return true if success, false on invalid character or if the workspace is too small.
+ *
+ */
+bool base58_decode_update(base58_decoder_t *ctx, const char *in, size_t in_len);
+
+/**
+ * Finish a streaming base 58 decoding and write the bytes.
+ *
+ * @param[in,out] ctx
+ *   Pointer to the decoder.
+ * @param[out]    out
+ *   Pointer to output byte buffer.
+ * @param[in]     out_len
+ *   Maximum length to write in output byte buffer.
+ *
+ * @return number of bytes decoded, -1 otherwise.
+ *
+ */
+int base58_decode_final(base58_decoder_t *ctx, uint8_t *out, size_t out_len);
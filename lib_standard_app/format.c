@@ -16,141 +16,251 @@
 
 #include <stddef.h>   // size_t
 #include <stdint.h>   // int*_t, uint*_t
-#include <string.h>   // strncpy, memmove
 #include <stdbool.h>  // bool
 
 #include "format.h"
 
-bool format_i64(char *dst, size_t dst_len, const int64_t value)
+// Decimal digits are written two at a time, from the end of the string
+static const char DIGIT_PAIRS[200] = {
+    '0', '0', '0', '1', '0', '2', '0', '3', '0', '4', '0', '5', '0', '6', '0', '7', '0', '8',  //
+    '0', '9', '1', '0', '1', '1', '1', '2', '1', '3', '1', '4', '1', '5', '1', '6', '1', '7',  //
+    '1', '8', '1', '9', '2', '0', '2', '1', '2', '2', '2', '3', '2', '4', '2', '5', '2', '6',  //
+    '2', '7', '2', '8', '2', '9', '3', '0', '3', '1', '3', '2', '3', '3', '3', '4', '3', '5',  //
+    '3', '6', '3', '7', '3', '8', '3', '9', '4', '0', '4', '1', '4', '2', '4', '3', '4', '4',  //
+    '4', '5', '4', '6', '4', '7', '4', '8', '4', '9', '5', '0', '5', '1', '5', '2', '5', '3',  //
+    '5', '4', '5', '5', '5', '6', '5', '7', '5', '8', '5', '9', '6', '0', '6', '1', '6', '2',  //
+    '6', '3', '6', '4', '6', '5', '6', '6', '6', '7', '6', '8', '6', '9', '7', '0', '7', '1',  //
+    '7', '2', '7', '3', '7', '4', '7', '5', '7', '6', '7', '7', '7', '8', '7', '9', '8', '0',  //
+    '8', '1', '8', '2', '8', '3', '8', '4', '8', '5', '8', '6', '8', '7', '8', '8', '8', '9',  //
+    '9', '0', '9', '1', '9', '2', '9', '3', '9', '4', '9', '5', '9', '6', '9', '7', '9', '8',  //
+    '9', '9'                                                                                   //
+};
+
+#define MAX_U64_DIGITS 20
+#define CHUNK_DIGITS   9
+#define CHUNK_BASE     1000000000U  // 10^CHUNK_DIGITS
+
+static const uint64_t POWERS_OF_10[MAX_U64_DIGITS] = {1ULL,
+                                                      10ULL,
+                                                      100ULL,
+                                                      1000ULL,
+                                                      10000ULL,
+                                                      100000ULL,
+                                                      1000000ULL,
+                                                      10000000ULL,
+                                                      100000000ULL,
+                                                      1000000000ULL,
+                                                      10000000000ULL,
+                                                      100000000000ULL,
+                                                      1000000000000ULL,
+                                                      10000000000000ULL,
+                                                      100000000000000ULL,
+                                                      1000000000000000ULL,
+                                                      10000000000000000ULL,
+                                                      100000000000000000ULL,
+                                                      1000000000000000000ULL,
+                                                      10000000000000000000ULL};
+
+// Number of decimal digits of value (1 for 0): log10 is estimated from log2 (1233 / 4096 is close
+// to log10(2)), then corrected with a single comparison
+static size_t count_digits(uint64_t value)
 {
-    char temp[] = "-9223372036854775808";
+    size_t estimate = ((64 - __builtin_clzll(value | 1)) * 1233) >> 12;
 
-    char   *ptr  = temp;
-    int64_t num  = value;
-    int     sign = 1;
+    if (value >= POWERS_OF_10[estimate]) {
+        estimate++;
+    }
+    return (estimate == 0) ? 1 : estimate;
+}
 
-    if (value < 0) {
-        sign = -1;
+// Writes the nb_digits last digits of value just before end, returns the first written character
+static char *write_chunk(char *end, uint32_t value, size_t nb_digits)
+{
+    while (nb_digits >= 2) {
+        const char *pair = &DIGIT_PAIRS[2 * (value % 100)];
+
+        value /= 100;
+        *--end = pair[1];
+        *--end = pair[0];
+        nb_digits -= 2;
     }
+    if (nb_digits != 0) {
+        *--end = '0' + (value % 10);
+    }
+    return end;
+}
 
-    while (num != 0) {
-        *ptr++ = '0' + (num % 10) * sign;
-        num /= 10;
+// Writes nb_digits digits of value (zero-padded) just before end, with a separator between each
+// group of 3 digits if separator is not '\0'. Returns the first written character.
+// Only one 64-bit division is done per 9 digits, the rest is done on 32-bit chunks.
+static char *write_digits(char *end, uint64_t value, size_t nb_digits, char separator)
+{
+    while (nb_digits > 0) {
+        uint32_t chunk;
+        size_t   chunk_digits;
+
+        if (nb_digits > CHUNK_DIGITS) {
+            uint64_t quotient = value / CHUNK_BASE;
+
+            chunk        = (uint32_t) (value - quotient * CHUNK_BASE);
+            chunk_digits = CHUNK_DIGITS;
+            value        = quotient;
+        }
+        else {
+            chunk        = (uint32_t) value;
+            chunk_digits = nb_digits;
+        }
+        nb_digits -= chunk_digits;
+
+        if (separator == '\0') {
+            end = write_chunk(end, chunk, chunk_digits);
+            continue;
+        }
+        // a chunk is made of 3 groups
+        while (chunk_digits > 3) {
+            end    = write_chunk(end, chunk % 1000, 3);
+            *--end = separator;
+            chunk /= 1000;
+            chunk_digits -= 3;
+        }
+        end = write_chunk(end, chunk, chunk_digits);
+        if (nb_digits != 0) {
+            *--end = separator;
+        }
     }
+    return end;
+}
 
-    if (value < 0) {
-        *ptr++ = '-';
+// Formats value / 10^decimals in a single pass: the length is computed first, then the string is
+// written straight into dst, from its end.
+static bool format_amount(char          *dst,
+                          size_t         dst_len,
+                          const uint64_t value,
+                          uint8_t        decimals,
+                          char           separator,
+                          bool           trimmed)
+{
+    uint64_t integer     = 0;
+    uint64_t fraction    = value;
+    size_t   frac_digits = decimals;
+    size_t   int_digits;
+    size_t   length;
+    char    *end;
+
+    if (decimals < MAX_U64_DIGITS) {
+        integer  = value / POWERS_OF_10[decimals];
+        fraction = value - integer * POWERS_OF_10[decimals];
     }
-    else if (value == 0) {
-        *ptr++ = '0';
+
+    if (trimmed && (fraction == 0)) {
+        frac_digits = 0;
     }
+    else if (trimmed) {
+        size_t   nb_zeros = 0;
+        uint32_t low;
 
-    int distance = (ptr - temp) + 1;
+        while ((fraction % CHUNK_BASE) == 0) {
+            fraction /= CHUNK_BASE;
+            frac_digits -= CHUNK_DIGITS;
+        }
+        for (low = (uint32_t) (fraction % CHUNK_BASE); (low % 10) == 0; low /= 10) {
+            nb_zeros++;
+        }
+        fraction /= POWERS_OF_10[nb_zeros];
+        frac_digits -= nb_zeros;
+    }
 
-    if ((int) dst_len < distance) {
+    int_digits = count_digits(integer);
+    length     = int_digits;
+    if (separator != '\0') {
+        length += (int_digits - 1) / 3;
+    }
+    if (frac_digits != 0) {
+        length += 1 + frac_digits;
+    }
+    if (dst_len <= length) {
         return false;
     }
 
-    size_t index = 0;
-
-    while (--ptr >= temp) {
-        dst[index++] = *ptr;
+    end  = dst + length;
+    *end = '\0';
+    if (frac_digits != 0) {
+        end    = write_digits(end, fraction, frac_digits, '\0');
+        *--end = '.';
     }
-
-    dst[index] = '\0';
+    write_digits(end, integer, int_digits, separator);
 
     return true;
 }
 
-bool format_u64(char *out, size_t outLen, uint64_t in)
+bool format_i64(char *dst, size_t dst_len, const int64_t value)
 {
-    size_t i = 0;
+    // the magnitude of INT64_MIN does not fit in an int64_t
+    uint64_t magnitude = (value < 0) ? 0 - (uint64_t) value : (uint64_t) value;
+    size_t   digits    = count_digits(magnitude);
+    size_t   length    = digits + ((value < 0) ? 1 : 0);
 
-    if (outLen == 0) {
+    if (dst_len <= length) {
         return false;
     }
-    outLen--;
 
-    while (in > 9) {
-        out[i] = in % 10 + '0';
-        in /= 10;
-        i++;
-        if (i + 1 > outLen) {
-            return false;
-        }
+    dst[length] = '\0';
+    write_digits(dst + length, magnitude, digits, '\0');
+    if (value < 0) {
+        dst[0] = '-';
     }
-    out[i]     = in + '0';
-    out[i + 1] = '\0';
 
-    uint8_t j = 0;
-    char    tmp;
-
-    // revert the string
-    while (j < i) {
-        // swap out[j] and out[i]
-        tmp    = out[j];
-        out[j] = out[i];
-        out[i] = tmp;
-
-        i--;
-        j++;
-    }
     return true;
 }
 
-bool format_fpu64(char *dst, size_t dst_len, const uint64_t value, uint8_t decimals)
+bool format_u64(char *out, size_t outLen, uint64_t in)
 {
-    char buffer[21] = {0};
+    size_t digits = count_digits(in);
 
-    if (!format_u64(buffer, sizeof(buffer), value)) {
+    if (outLen <= digits) {
         return false;
     }
 
-    size_t digits = strlen(buffer);
+    out[digits] = '\0';
+    write_digits(out + digits, in, digits, '\0');
 
-    if (digits <= decimals) {
-        if (dst_len <= 2 + decimals - digits) {
-            return false;
-        }
-        *dst++ = '0';
-        *dst++ = '.';
-        for (uint16_t i = 0; i < decimals - digits; i++, dst++) {
-            *dst = '0';
-        }
-        dst_len -= 2 + decimals - digits;
-        strncpy(dst, buffer, dst_len);
-    }
-    else {
-        if (dst_len <= digits + 1 + decimals) {
-            return false;
-        }
+    return true;
+}
+
+// Values with an integer part have always required room for the decimals twice
+static bool fpu64_fits(size_t dst_len, const uint64_t value, uint8_t decimals)
+{
+    size_t digits = count_digits(value);
 
-        const size_t shift = digits - decimals;
-        memmove(dst, buffer, shift);
-        dst[shift] = '.';
-        strncpy(dst + shift + 1, buffer + shift, decimals);
+    return (digits <= decimals) || (dst_len > digits + 1 + decimals);
+}
+
+bool format_fpu64(char *dst, size_t dst_len, const uint64_t value, uint8_t decimals)
+{
+    if (!fpu64_fits(dst_len, value, decimals)) {
+        return false;
     }
 
-    return true;
+    return format_amount(dst, dst_len, value, decimals, '\0', false);
 }
 
 bool format_fpu64_trimmed(char *dst, size_t dst_len, const uint64_t value, uint8_t decimals)
 {
-    if (!format_fpu64(dst, dst_len, value, decimals)) {
+    if (!fpu64_fits(dst_len, value, decimals)) {
         return false;
     }
 
-    size_t len = strlen(dst);
+    return format_amount(dst, dst_len, value, decimals, '\0', true);
+}
 
-    while (len > 0 && (dst[len - 1] == '0' || dst[len - 1] == '.')) {
-        if (dst[len - 1] == '.') {
-            dst[len - 1] = '\0';
-            return true;
-        }
-        len--;
-    }
-    dst[len] = '\0';
-    return true;
+bool format_fpu64_grouped(char          *dst,
+                          size_t         dst_len,
+                          const uint64_t value,
+                          uint8_t        decimals,
+                          char           separator,
+                          bool           trimmed)
+{
+    return format_amount(dst, dst_len, value, decimals, separator, trimmed);
 }
 
 int format_hex(const uint8_t *in, size_t in_len, char *out, size_t out_len)
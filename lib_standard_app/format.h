@@ -46,7 +46,7 @@ bool format_u64(char *dst, size_t dst_len, uint64_t value);
  * @param[in]  decimals
  *   Number of digits after decimal separator.
  *
- * @return true if success, false otherwise.
+ * @return true if success, false otherwise (the formatted value is never truncated).
  *
  */
 bool format_fpu64(char *dst, size_t dst_len, const uint64_t value, uint8_t decimals);
@@ -63,11 +63,38 @@ bool format_fpu64(char *dst, size_t dst_len, const uint64_t value, uint8_t decim
  * @param[in]  decimals
  *   Number of digits after decimal separator.
  *
- * @return true if success, false otherwise.
+ * @return true if success, false otherwise (dst only has to fit the trimmed value).
  *
  */
 bool format_fpu64_trimmed(char *dst, size_t dst_len, const uint64_t value, uint8_t decimals);
 
+/**
+ * Format 64-bit unsigned integer as string with decimals, and a separator between each group of
+ * 3 digits of the integer part.
+ *
+ * @param[out] dst
+ *   Pointer to output string.
+ * @param[in]  dst_len
+ *   Length of output string.
+ * @param[in]  value
+ *   64-bit unsigned integer to format.
+ * @param[in]  decimals
+ *   Number of digits after decimal separator.
+ * @param[in]  separator
+ *   Thousands separator, or '\0' for none.
+ * @param[in]  trimmed
+ *   If true, trailing zeros of the decimals and the dot are trimmed.
+ *
+ * @return true if success, false otherwise.
+ *
+ */
+bool format_fpu64_grouped(char          *dst,
+                          size_t         dst_len,
+                          const uint64_t value,
+                          uint8_t        decimals,
+                          char           separator,
+                          bool           trimmed);
+
 /**
  * Format byte buffer to uppercase hexadecimal string.
  *
@@ -68,4 +68,7 @@ int32_t USBD_LEDGER_HID_U2F_data_ready(USBD_HandleTypeDef *pdev,
 
 void USBD_LEDGER_HID_U2F_setting(uint32_t id, uint8_t *buffer, uint16_t length, void *cookie);
 
+// Lets the pending CTAPHID channels time out, to be called on each ticker event
+void USBD_LEDGER_HID_U2F_ticker(uint32_t interval_ms);
+
 #endif  // USBD_LEDGER_HID_U2F_H
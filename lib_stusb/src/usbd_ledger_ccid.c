@@ -315,7 +315,7 @@ USBD_StatusTypeDef USBD_LEDGER_CCID_data_in(USBD_HandleTypeDef *pdev, void *cook
             handle->state = LEDGER_CCID_STATE_BUSY;
             USBD_LL_Transmit(pdev,
                              LEDGER_CCID_BULK_EPIN_ADDR,
-                             ledger_ccid_transport_packet_buffer,
+                             handle->device.transport.tx_packet,
                              handle->device.transport.tx_packet_length,
                              0);
         }
@@ -373,7 +373,7 @@ USBD_StatusTypeDef USBD_LEDGER_CCID_send_packet(USBD_HandleTypeDef *pdev,
                 handle->state = LEDGER_CCID_STATE_BUSY;
                 ret           = USBD_LL_Transmit(pdev,
                                        LEDGER_CCID_BULK_EPIN_ADDR,
-                                       ledger_ccid_transport_packet_buffer,
+                                       handle->device.transport.tx_packet,
                                        handle->device.transport.tx_packet_length,
                                        timeout_ms);
             }
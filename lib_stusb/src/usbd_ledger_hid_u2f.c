@@ -782,4 +782,13 @@ void USBD_LEDGER_HID_U2F_setting(uint32_t id, uint8_t *buffer, uint16_t length,
     }
 }
 
+void USBD_LEDGER_HID_U2F_ticker(uint32_t interval_ms)
+{
+#if U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
+    U2F_TRANSPORT_ticker(&ledger_hid_u2f_handle.transport_data, interval_ms);
+#else   // U2F_TRANSPORT_MAX_PENDING_CHANNELS == 0
+    UNUSED(interval_ms);
+#endif  // U2F_TRANSPORT_MAX_PENDING_CHANNELS == 0
+}
+
 #endif  // HAVE_IO_U2F
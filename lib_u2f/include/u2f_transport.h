@@ -26,7 +26,49 @@ typedef enum {
     U2F_TRANSPORT_TYPE_BLE     = 0x01,
 } u2f_transport_type_t;
 
+/* Exported defines   --------------------------------------------------------*/
+#define U2F_FORBIDDEN_CID (0x00000000)
+#define U2F_BROADCAST_CID (0xFFFFFFFF)
+
+// Number of USB HID channels whose requests can be buffered while another channel is being
+// processed. When this table is full (or disabled), such requests get CTAP1_ERR_CHANNEL_BUSY.
+// Disabled by default as it costs RAM to every U2F app: add e.g.
+// U2F_TRANSPORT_MAX_PENDING_CHANNELS=2 to the app DEFINES to enable it.
+// The requests are buffered by the USB stack which receives the HID packets. With
+// USE_OS_IO_STACK (the default for apps), this is the OS one, and enabling this option in the app
+// does nothing: it only takes effect in apps built with their own IO stack
+// (DISABLE_OS_IO_STACK_USE=1).
+#ifndef U2F_TRANSPORT_MAX_PENDING_CHANNELS
+#define U2F_TRANSPORT_MAX_PENDING_CHANNELS (0)
+#endif  // U2F_TRANSPORT_MAX_PENDING_CHANNELS
+
+// Max size of a request (CMD + BCNT + DATA) buffered for a pending channel. Larger requests, such
+// as most CTAP2 (CBOR) ones, a CTAPHID message being up to 7609 bytes, are not buffered: their
+// initialization packet is answered with CTAP1_ERR_CHANNEL_BUSY, as without pending channels, and
+// the client has to send them again. Raise it for CTAP2 clients, at the cost of RAM per channel.
+#ifndef U2F_TRANSPORT_PENDING_MESSAGE_SIZE
+#define U2F_TRANSPORT_PENDING_MESSAGE_SIZE (64)
+#endif  // U2F_TRANSPORT_PENDING_MESSAGE_SIZE
+
+// CTAPHID transaction timeout: a pending channel whose request is still incomplete is freed when
+// no packet has been received on it for this duration
+#ifndef U2F_TRANSPORT_TRANSACTION_TIMEOUT_MS
+#define U2F_TRANSPORT_TRANSACTION_TIMEOUT_MS (3000)
+#endif  // U2F_TRANSPORT_TRANSACTION_TIMEOUT_MS
+
 /* Exported types, structures, unions ----------------------------------------*/
+#if U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
+typedef struct {
+    uint32_t cid;
+    uint8_t  state;  // U2F_STATE_IDLE (free slot), U2F_STATE_CMD_FRAMING or U2F_STATE_CMD_COMPLETE
+    uint8_t  expected_sequence_number;
+    uint16_t length;
+    uint16_t offset;
+    uint16_t remaining_ms;  // before the transaction timeout, while in U2F_STATE_CMD_FRAMING
+    uint8_t  buffer[U2F_TRANSPORT_PENDING_MESSAGE_SIZE];
+} u2f_transport_channel_t;
+#endif  // U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
+
 typedef struct {
     u2f_transport_type_t type;
 
@@ -49,12 +91,12 @@ typedef struct {
     uint16_t rx_message_length;
     uint16_t rx_message_offset;
 
+#if U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
+    // Requests received on other channels while the one above is in use
+    u2f_transport_channel_t pending_channels[U2F_TRANSPORT_MAX_PENDING_CHANNELS];
+#endif  // U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
 } u2f_transport_t;
 
-/* Exported defines   --------------------------------------------------------*/
-#define U2F_FORBIDDEN_CID (0x00000000)
-#define U2F_BROADCAST_CID (0xFFFFFFFF)
-
 /* Exported macros------------------------------------------------------------*/
 
 /* Exported variables --------------------------------------------------------*/
@@ -68,3 +110,6 @@ void U2F_TRANSPORT_tx(u2f_transport_t *handle,
                       uint16_t         length,
                       uint8_t         *tx_packer_buffer,
                       uint16_t         tx_packet_buffer_size);
+#if U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
+void U2F_TRANSPORT_ticker(u2f_transport_t *handle, uint32_t interval_ms);
+#endif  // U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
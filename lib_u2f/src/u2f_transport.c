@@ -40,6 +40,13 @@
 /* Private macros-------------------------------------------------------------*/
 
 /* Private functions prototypes ----------------------------------------------*/
+#if U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
+static u2f_error_t process_pending_packet(u2f_transport_t *handle,
+                                          uint32_t         cid,
+                                          uint8_t         *buffer,
+                                          uint16_t         length);
+static void        promote_pending_channel(u2f_transport_t *handle);
+#endif  // U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
 static u2f_error_t process_packet(u2f_transport_t *handle, uint8_t *buffer, uint16_t length);
 
 /* Exported variables --------------------------------------------------------*/
@@ -47,6 +54,146 @@ static u2f_error_t process_packet(u2f_transport_t *handle, uint8_t *buffer, uint
 /* Private variables ---------------------------------------------------------*/
 
 /* Private functions ---------------------------------------------------------*/
+#if U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
+// Reassemble a packet received on a channel which is not the one in use.
+// The request is kept in a pending channel until the current one is released.
+static u2f_error_t process_pending_packet(u2f_transport_t *handle,
+                                          uint32_t         cid,
+                                          uint8_t         *buffer,
+                                          uint16_t         length)
+{
+    u2f_error_t              error   = CTAP1_ERR_SUCCESS;
+    u2f_transport_channel_t *channel = NULL;
+    uint8_t                  index   = 0;
+
+    for (index = 0; index < U2F_TRANSPORT_MAX_PENDING_CHANNELS; index++) {
+        if ((handle->pending_channels[index].state != U2F_STATE_IDLE)
+            && (handle->pending_channels[index].cid == cid)) {
+            channel = &handle->pending_channels[index];
+            break;
+        }
+    }
+
+    // Check header length
+    if (length < 1) {
+        error = CTAP1_ERR_OTHER;
+        goto end;
+    }
+
+    if (buffer[0] & 0x80) {
+        // Initialization packet
+        if (!channel) {
+            for (index = 0; index < U2F_TRANSPORT_MAX_PENDING_CHANNELS; index++) {
+                if (handle->pending_channels[index].state == U2F_STATE_IDLE) {
+                    channel = &handle->pending_channels[index];
+                    break;
+                }
+            }
+        }
+        if (!channel) {
+            // No room left to buffer this request
+            error = CTAP1_ERR_CHANNEL_BUSY;
+            goto end;
+        }
+        else if (channel->state == U2F_STATE_CMD_COMPLETE) {
+            // A request is already waiting on this channel
+            error = CTAP1_ERR_CHANNEL_BUSY;
+            goto end;
+        }
+        channel->state = U2F_STATE_IDLE;
+        if (length < 3) {
+            error = CTAP1_ERR_OTHER;
+            goto end;
+        }
+        channel->length = (uint16_t) U2BE(buffer, 1) + 3;
+        if (channel->length > sizeof(channel->buffer)) {
+            // Too large to be buffered (see U2F_TRANSPORT_PENDING_MESSAGE_SIZE): reject it right
+            // away, the client will have to send it again once the channel in use is released
+            error = CTAP1_ERR_CHANNEL_BUSY;
+            goto end;
+        }
+        else if ((channel->length <= 3) && (buffer[0] == (U2F_COMMAND_HID_CBOR | 0x80))) {
+            // Empty CBOR request, rejected as such once sent again on a free channel
+            error = CTAP1_ERR_CHANNEL_BUSY;
+            goto end;
+        }
+        channel->cid                       = cid;
+        channel->state                     = U2F_STATE_CMD_FRAMING;
+        channel->offset                    = 0;
+        channel->buffer[channel->offset++] = buffer[0] & 0x7F;  // CMD
+        channel->buffer[channel->offset++] = buffer[1];         // BCNTH
+        channel->buffer[channel->offset++] = buffer[2];         // BCNTL
+        channel->expected_sequence_number  = 0;
+        channel->remaining_ms              = U2F_TRANSPORT_TRANSACTION_TIMEOUT_MS;
+        buffer += 3;
+        length -= 3;
+    }
+    else {
+        // Continuation packet
+        if (!channel || (channel->state != U2F_STATE_CMD_FRAMING)) {
+            error = CTAP1_ERR_OTHER;
+            goto end;
+        }
+        else if (buffer[0] != channel->expected_sequence_number) {
+            channel->state = U2F_STATE_IDLE;
+            error          = CTAP1_ERR_INVALID_SEQ;
+            goto end;
+        }
+        channel->expected_sequence_number++;
+        channel->remaining_ms = U2F_TRANSPORT_TRANSACTION_TIMEOUT_MS;
+        buffer += 1;
+        length -= 1;
+    }
+
+    if (length > channel->length - channel->offset) {
+        length = channel->length - channel->offset;
+    }
+    memcpy(&channel->buffer[channel->offset], buffer, length);
+    channel->offset += length;
+
+    if (channel->offset == channel->length) {
+        channel->state = U2F_STATE_CMD_COMPLETE;
+    }
+
+end:
+    return error;
+}
+
+// Hand the oldest buffered request over to the rx message buffer, once the channel in use has
+// been released. A complete request is preferred, so that it can be dispatched right away.
+static void promote_pending_channel(u2f_transport_t *handle)
+{
+    u2f_transport_channel_t *channel = NULL;
+    uint8_t                  index   = 0;
+
+    if ((handle->cid != U2F_FORBIDDEN_CID) || handle->tx_message_buffer) {
+        return;
+    }
+
+    for (index = 0; index < U2F_TRANSPORT_MAX_PENDING_CHANNELS; index++) {
+        if (handle->pending_channels[index].state == U2F_STATE_CMD_COMPLETE) {
+            channel = &handle->pending_channels[index];
+            break;
+        }
+        if (!channel && (handle->pending_channels[index].state == U2F_STATE_CMD_FRAMING)) {
+            channel = &handle->pending_channels[index];
+        }
+    }
+    if (!channel || (channel->offset > handle->rx_message_buffer_size)) {
+        return;
+    }
+
+    memcpy(handle->rx_message_buffer, channel->buffer, channel->offset);
+    handle->cid                                 = channel->cid;
+    handle->tx_cid                              = channel->cid;
+    handle->state                               = channel->state;
+    handle->rx_message_length                   = channel->length;
+    handle->rx_message_offset                   = channel->offset;
+    handle->rx_message_expected_sequence_number = channel->expected_sequence_number;
+    channel->state                              = U2F_STATE_IDLE;
+}
+#endif  // U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
+
 static u2f_error_t process_packet(u2f_transport_t *handle, uint8_t *buffer, uint16_t length)
 {
     u2f_error_t error = CTAP1_ERR_SUCCESS;
@@ -60,22 +207,36 @@ static u2f_error_t process_packet(u2f_transport_t *handle, uint8_t *buffer, uint
             goto end;
         }
         uint32_t message_cid = U4BE(buffer, 0);
-        handle->tx_cid       = message_cid;
+#if U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
+        promote_pending_channel(handle);
+#endif  // U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
         if (message_cid == U2F_FORBIDDEN_CID) {
             // Forbidden CID
-            error = CTAP1_ERR_INVALID_CHANNEL;
+            handle->tx_cid = message_cid;
+            error          = CTAP1_ERR_INVALID_CHANNEL;
             goto end;
         }
         else if ((message_cid == U2F_BROADCAST_CID) && (length >= 5)
                  && (buffer[4] != (U2F_COMMAND_HID_INIT | 0x80))) {
             // Broadcast CID but not an init message
-            error       = CTAP1_ERR_INVALID_CHANNEL;
-            handle->cid = message_cid;
+            handle->tx_cid = message_cid;
+            error          = CTAP1_ERR_INVALID_CHANNEL;
+            if (handle->cid == U2F_FORBIDDEN_CID) {
+                handle->cid = message_cid;
+            }
             goto end;
         }
         else if ((handle->cid != U2F_FORBIDDEN_CID) && (handle->cid != message_cid)) {
             // CID is already set
+#if U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
+            // Buffer the request of this other channel until the current one is released
+            error = process_pending_packet(handle, message_cid, buffer + 4, length - 4);
+#else   // U2F_TRANSPORT_MAX_PENDING_CHANNELS == 0
             error = CTAP1_ERR_CHANNEL_BUSY;
+#endif  // U2F_TRANSPORT_MAX_PENDING_CHANNELS == 0
+            if (error != CTAP1_ERR_SUCCESS) {
+                handle->tx_cid = message_cid;
+            }
             goto end;
         }
         else if ((handle->state > U2F_STATE_CMD_FRAMING) && (length >= 5)
@@ -86,13 +247,15 @@ static u2f_error_t process_packet(u2f_transport_t *handle, uint8_t *buffer, uint
             // still authorized.
             // TODO: to check the use case when on-going CTAPHID_CANCEL needs to interrupt UI and to
             // respond with ERROR_KEEPALIVE_CANCEL while a new U2F_TRANSPORT_TYPE_USB_HID is coming.
-            error = CTAP1_ERR_CHANNEL_BUSY;
+            handle->tx_cid = message_cid;
+            error          = CTAP1_ERR_CHANNEL_BUSY;
             goto end;
         }
         else if (handle->cid == U2F_FORBIDDEN_CID) {
             // Set new CID
             handle->cid = message_cid;
         }
+        handle->tx_cid = message_cid;
         buffer += 4;
         length -= 4;
     }
@@ -176,6 +339,9 @@ void U2F_TRANSPORT_init(u2f_transport_t *handle, uint8_t type)
     handle->state = U2F_STATE_IDLE;
     handle->cid   = U2F_FORBIDDEN_CID;
     handle->type  = type;
+#if U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
+    memset(handle->pending_channels, 0, sizeof(handle->pending_channels));
+#endif  // U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
 }
 
 void U2F_TRANSPORT_rx(u2f_transport_t *handle, uint8_t *buffer, uint16_t length)
@@ -247,9 +413,45 @@ void U2F_TRANSPORT_tx(u2f_transport_t *handle,
         tx_packet_offset += (handle->tx_message_length - handle->tx_message_offset);
         handle->tx_message_offset = handle->tx_message_length;
         handle->tx_message_buffer = NULL;
-        handle->cid               = U2F_FORBIDDEN_CID;
+        if ((handle->cid == U2F_FORBIDDEN_CID) || (handle->tx_cid == handle->cid)) {
+            // End of the response, the channel is released
+            handle->cid = U2F_FORBIDDEN_CID;
+#if U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
+            promote_pending_channel(handle);
+#endif  // U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
+        }
+        else {
+            // Error sent to another channel, the channel in use is kept
+            handle->tx_cid = handle->cid;
+        }
     }
 
     handle->tx_packet_length = tx_packet_offset;
     LOG_IO(" %d\n", handle->tx_packet_length);
 }
+
+#if U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
+void U2F_TRANSPORT_ticker(u2f_transport_t *handle, uint32_t interval_ms)
+{
+    uint8_t index = 0;
+
+    if (!handle) {
+        return;
+    }
+
+    for (index = 0; index < U2F_TRANSPORT_MAX_PENDING_CHANNELS; index++) {
+        u2f_transport_channel_t *channel = &handle->pending_channels[index];
+        if (channel->state != U2F_STATE_CMD_FRAMING) {
+            continue;
+        }
+        if (channel->remaining_ms <= interval_ms) {
+            // Transaction timeout, the client of this channel is gone: free its slot
+            channel->remaining_ms = 0;
+            channel->state        = U2F_STATE_IDLE;
+        }
+        else {
+            channel->remaining_ms -= interval_ms;
+        }
+    }
+}
+#endif  // U2F_TRANSPORT_MAX_PENDING_CHANNELS > 0
@@ -7,6 +7,11 @@
 
 #define PIXEL_PER_LINE 114
 
+// max number of pages whose start is recorded when counting pages
+#ifndef UX_LAYOUT_PAGING_PAGE_STARTS
+#define UX_LAYOUT_PAGING_PAGE_STARTS 16
+#endif  // UX_LAYOUT_PAGING_PAGE_STARTS
+
 #define PAGING_FORMAT_NN 0x00
 #define PAGING_FORMAT_BN 0xF0
 #define PAGING_FORMAT_NB 0x0F
@@ -32,6 +37,9 @@ typedef struct {
 #endif  // defined(HAVE_INDEXED_STRINGS)
     unsigned short offsets[MAX_PAGING_LINE_COUNT];
     unsigned short lengths[MAX_PAGING_LINE_COUNT];
+    // offset of the first char of each page, recorded when counting pages
+    unsigned short page_starts[UX_LAYOUT_PAGING_PAGE_STARTS];
+    unsigned char  nb_page_starts;
 #if defined(HAVE_INDEXED_STRINGS)
     unsigned char fond_ids[MAX_PAGING_LINE_COUNT];
     char          line_buffer[LINE_BUFFER_SIZE + 1];
@@ -17,6 +17,31 @@ static bool is_word_delim(unsigned char c)
     return c == ' ' || c == '\n' || c == '-' || c == '_';
 }
 
+// return the number of bytes of the char starting at text, decoded the same way as in
+// bagl_draw_string(), so that a line is never split within an UTF-8 sequence
+static unsigned int char_length(const char *text, const char *end)
+{
+#if defined(HAVE_UNICODE_SUPPORT)
+    unsigned char c         = *text;
+    unsigned int  remaining = end - text;
+
+    if (c >= 0xF0 && remaining >= 4) {
+        return 4;
+    }
+    else if (c >= 0xE0 && remaining >= 3) {
+        return 3;
+    }
+    else if ((c >= 0xC2 || c == '\e') && remaining >= 2) {
+        // '\e' is ignored by BAGL, together with its extra byte
+        return 2;
+    }
+#else   // defined(HAVE_UNICODE_SUPPORT)
+    UNUSED(text);
+    UNUSED(end);
+#endif  // defined(HAVE_UNICODE_SUPPORT)
+    return 1;
+}
+
 // return the number of pages to be displayed when current page to show is -1
 unsigned int ux_layout_paging_compute(const char               *text_to_split,
                                       unsigned int              page_to_display,
@@ -42,33 +67,62 @@ unsigned int ux_layout_paging_compute(const char               *text_to_split,
     const char  *start  = (text_to_split ? STRPIC(text_to_split) : G_ux.externalText);
     const char  *start2 = start;
     const char  *end    = start + strlen(start);
+
+    if (page_to_display == (unsigned int) -1) {
+        paging_state->nb_page_starts = 0;
+    }
+    else if (page_to_display < paging_state->nb_page_starts) {
+        // the start of the page has been recorded when counting pages, don't walk the previous ones
+        page  = page_to_display;
+        start = start2 + paging_state->page_starts[page];
+    }
     while (start < end) {
         unsigned int len             = 0;
         unsigned int linew           = 0;
         const char  *last_word_delim = start;
+#ifdef HAVE_FONTS
+        // each line is measured with the initial font, as done by bagl_compute_line_width()
+        bagl_font_id_e line_font = font;
+#endif  // HAVE_FONTS
+
+        if (line == 0 && page_to_display == (unsigned int) -1
+            && page < UX_LAYOUT_PAGING_PAGE_STARTS) {
+            paging_state->page_starts[page] = start - start2;
+            paging_state->nb_page_starts    = page + 1;
+        }
         // not reached end of content
         while (start + len < end
-               // line is not full
-               && linew <= PIXEL_PER_LINE
                // avoid display buffer overflow for each line
                // && len < sizeof(G_ux.string_buffer)-1
         ) {
-            // compute new line length
+            // the width of the line is the sum of the advances of its chars: only measure the new
+            // one, instead of the whole line again
+            unsigned int char_len = char_length(&start[len], end);
+            unsigned int char_w;
 #ifdef HAVE_FONTS
-            linew = bagl_compute_line_width(font, 0, start, len + 1, BAGL_ENCODING_DEFAULT);
+            char_w = bagl_compute_line_width(
+                line_font, 0, &start[len], char_len, BAGL_ENCODING_DEFAULT);
+#if defined(HAVE_UNICODE_SUPPORT)
+            if (start[len] == '\b') {
+                // bold toggle, same as toggle_bold()
+                line_font = (line_font == BAGL_FONT_OPEN_SANS_REGULAR_11px)
+                                ? BAGL_FONT_OPEN_SANS_EXTRABOLD_11px
+                                : BAGL_FONT_OPEN_SANS_REGULAR_11px;
+            }
+#endif  // defined(HAVE_UNICODE_SUPPORT)
 #else   // HAVE_FONTS
-            linew = se_compute_line_width_light(start, len + 1, G_ux.layout_paging.format);
+            char_w = se_compute_line_width_light(&start[len], char_len, G_ux.layout_paging.format);
 #endif  // HAVE_FONTS
-        // if (start[len] )
-            if (linew > PIXEL_PER_LINE) {
+            if (linew + char_w > PIXEL_PER_LINE) {
                 // we got a full line
                 break;
             }
+            linew += char_w;
             unsigned char c = start[len];
             if (is_word_delim(c)) {
                 last_word_delim = &start[len];
             }
-            len++;
+            len += char_len;
             // new line, don't go further
             if (c == '\n') {
                 break;
@@ -69,12 +69,20 @@ testable int  getNumDataCodewords(int version, enum qrcodegen_Ecc ecl);
 testable int  getNumRawDataModules(int ver);
 
 testable void    reedSolomonComputeDivisor(int degree, uint8_t result[]);
-testable void    reedSolomonComputeRemainder(const uint8_t data[],
-                                             int           dataLen,
-                                             const uint8_t generator[],
-                                             int           degree,
-                                             uint8_t       result[]);
+#ifdef QRCODEGEN_TEST
+testable void reedSolomonComputeRemainder(const uint8_t data[],
+                                          int           dataLen,
+                                          const uint8_t generator[],
+                                          int           degree,
+                                          uint8_t       result[]);
+#endif  // QRCODEGEN_TEST
 testable uint8_t reedSolomonMultiply(uint8_t x, uint8_t y);
+static const uint8_t *reedSolomonGetDivisorLogs(int degree, uint8_t buffer[]);
+static void           reedSolomonComputeRemainderLogs(const uint8_t data[],
+                                                      int           dataLen,
+                                                      const uint8_t generatorLogs[],
+                                                      int           degree,
+                                                      uint8_t       result[]);
 
 testable void initializeFunctionModules(int version, uint8_t qrcode[]);
 static void   drawLightFunctionModules(uint8_t qrcode[], int version);
@@ -84,7 +92,7 @@ static void   fillRectangle(int left, int top, int width, int height, uint8_t qr
 
 static void drawCodewords(const uint8_t data[], int dataLen, uint8_t qrcode[]);
 static void applyMask(const uint8_t functionModules[], uint8_t qrcode[], enum qrcodegen_Mask mask);
-static long getPenaltyScore(const uint8_t qrcode[]);
+static long getPenaltyScore(const uint8_t qrcode[], long bound);
 static int  finderPenaltyCountPatterns(const int runHistory[7], int qrsize);
 static int  finderPenaltyTerminateAndCount(bool currentRunColor,
                                            int  currentRunLength,
@@ -125,6 +133,72 @@ testable const int8_t ECC_CODEWORDS_PER_BLOCK[4][41] = {
 
 #define qrcodegen_REED_SOLOMON_DEGREE_MAX 30  // Based on the table above
 
+// clang-format off
+// Antilogarithms of GF(2^8/0x11D) in base 0x02: GF_EXP[i] = 0x02^i, for 0 <= i < 255.
+static const uint8_t GF_EXP[255] = {
+      1,   2,   4,   8,  16,  32,  64, 128,  29,  58, 116, 232, 205, 135,  19,  38,
+     76, 152,  45,  90, 180, 117, 234, 201, 143,   3,   6,  12,  24,  48,  96, 192,
+    157,  39,  78, 156,  37,  74, 148,  53, 106, 212, 181, 119, 238, 193, 159,  35,
+     70, 140,   5,  10,  20,  40,  80, 160,  93, 186, 105, 210, 185, 111, 222, 161,
+     95, 190,  97, 194, 153,  47,  94, 188, 101, 202, 137,  15,  30,  60, 120, 240,
+    253, 231, 211, 187, 107, 214, 177, 127, 254, 225, 223, 163,  91, 182, 113, 226,
+    217, 175,  67, 134,  17,  34,  68, 136,  13,  26,  52, 104, 208, 189, 103, 206,
+    129,  31,  62, 124, 248, 237, 199, 147,  59, 118, 236, 197, 151,  51, 102, 204,
+    133,  23,  46,  92, 184, 109, 218, 169,  79, 158,  33,  66, 132,  21,  42,  84,
+    168,  77, 154,  41,  82, 164,  85, 170,  73, 146,  57, 114, 228, 213, 183, 115,
+    230, 209, 191,  99, 198, 145,  63, 126, 252, 229, 215, 179, 123, 246, 241, 255,
+    227, 219, 171,  75, 150,  49,  98, 196, 149,  55, 110, 220, 165,  87, 174,  65,
+    130,  25,  50, 100, 200, 141,   7,  14,  28,  56, 112, 224, 221, 167,  83, 166,
+     81, 162,  89, 178, 121, 242, 249, 239, 195, 155,  43,  86, 172,  69, 138,   9,
+     18,  36,  72, 144,  61, 122, 244, 245, 247, 243, 251, 235, 203, 139,  11,  22,
+     44,  88, 176, 125, 250, 233, 207, 131,  27,  54, 108, 216, 173,  71, 142,
+};
+
+// Logarithms of GF(2^8/0x11D) in base 0x02: GF_LOG[GF_EXP[i]] = i. GF_LOG[0] is undefined.
+static const uint8_t GF_LOG[256] = {
+      0,   0,   1,  25,   2,  50,  26, 198,   3, 223,  51, 238,  27, 104, 199,  75,
+      4, 100, 224,  14,  52, 141, 239, 129,  28, 193, 105, 248, 200,   8,  76, 113,
+      5, 138, 101,  47, 225,  36,  15,  33,  53, 147, 142, 218, 240,  18, 130,  69,
+     29, 181, 194, 125, 106,  39, 249, 185, 201, 154,   9, 120,  77, 228, 114, 166,
+      6, 191, 139,  98, 102, 221,  48, 253, 226, 152,  37, 179,  16, 145,  34, 136,
+     54, 208, 148, 206, 143, 150, 219, 189, 241, 210,  19,  92, 131,  56,  70,  64,
+     30,  66, 182, 163, 195,  72, 126, 110, 107,  58,  40,  84, 250, 133, 186,  61,
+    202,  94, 155, 159,  10,  21, 121,  43,  78, 212, 229, 172, 115, 243, 167,  87,
+      7, 112, 192, 247, 140, 128,  99,  13, 103,  74, 222, 237,  49, 197, 254,  24,
+    227, 165, 153, 119,  38, 184, 180, 124,  17,  68, 146, 217,  35,  32, 137,  46,
+     55,  63, 209,  91, 149, 188, 207, 205, 144, 135, 151, 178, 220, 252, 190,  97,
+    242,  86, 211, 171,  20,  42,  93, 158, 132,  60,  57,  83,  71, 109,  65, 162,
+     31,  45,  67, 216, 183, 123, 164, 118, 196,  23,  73, 236, 127,  12, 111, 246,
+    108, 161,  59,  82,  41, 157,  85, 170, 251,  96, 134, 177, 187, 204,  62,  90,
+    203,  89,  95, 176, 156, 169, 160,  81,  11, 245,  22, 235, 122, 117,  44, 215,
+     79, 174, 213, 233, 230, 231, 173, 232, 116, 214, 244, 234, 168,  80,  88, 175,
+};
+
+// Reed-Solomon generator polynomials for the even degrees from RS_DIVISOR_DEGREE_FIRST to
+// qrcodegen_REED_SOLOMON_DEGREE_MAX, which are the only ones used by the versions from
+// qrcodegen_VERSION_MIN to qrcodegen_VERSION_MAX. They are stored as reedSolomonComputeDivisor()
+// would compute them, but each coefficient is replaced by its logarithm (none of them is zero).
+#define RS_DIVISOR_DEGREE_FIRST 16
+static const uint8_t RS_DIVISOR_LOGS[8][qrcodegen_REED_SOLOMON_DEGREE_MAX] = {
+    {120, 104, 107, 109, 102, 161,  76,   3,  91, 191, 147, 169, 182, 194, 225,
+     120}, // degree 16
+    {215, 234, 158,  94, 184,  97, 118, 170,  79, 187, 152, 148, 252, 179,   5,
+      98,  96, 153}, // degree 18
+    { 17,  60,  79,  50,  61, 163,  26, 187, 202, 180, 221, 225,  83, 239, 156,
+     164, 212, 212, 188, 190}, // degree 20
+    {210, 171, 247, 242,  93, 230,  14, 109, 221,  53, 200,  74,   8, 172,  98,
+      80, 219, 134, 160, 105, 165, 231}, // degree 22
+    {229, 121, 135,  48, 211, 117, 251, 126, 159, 180, 169, 152, 192, 226, 228,
+     218, 111,   0, 117, 232,  87,  96, 227,  21}, // degree 24
+    {173, 125, 158,   2, 103, 182, 118,  17, 145, 201, 111,  28, 165,  53, 161,
+      21, 245, 142,  13, 102,  48, 227, 153, 145, 218,  70}, // degree 26
+    {168, 223, 200, 104, 224, 234, 108, 180, 110, 190, 195, 147, 205,  27, 232,
+     201,  21,  43, 245,  87,  42, 195, 212, 119, 242,  37,   9, 123}, // degree 28
+    { 41, 173, 145, 152, 216,  31, 179, 182,  50,  48, 110,  86, 239,  96, 222,
+     125,  42, 173, 226, 193, 224, 130, 156,  37, 251, 216, 238,  40, 192, 180}, // degree 30
+};
+// clang-format on
+
 // For generating error correction codes.
 testable const int8_t NUM_ERROR_CORRECTION_BLOCKS[4][41] = {
   // Version: (note that index 0 is for padding, and is set to an illegal value)
@@ -339,7 +413,7 @@ bool qrcodegen_encodeSegmentsAdvanced(const struct qrcodegen_Segment segs[],
             enum qrcodegen_Mask msk = (enum qrcodegen_Mask) i;
             applyMask(tempBuffer, qrcode, msk);
             drawFormatBits(ecl, msk, qrcode);
-            long penalty = getPenaltyScore(qrcode);
+            long penalty = getPenaltyScore(qrcode, minPenalty);
             if (penalty < minPenalty) {
                 mask       = msk;
                 minPenalty = penalty;
@@ -376,13 +450,13 @@ testable void addEccAndInterleave(uint8_t            data[],
 
     // Split data into blocks, calculate ECC, and interleave
     // (not concatenate) the bytes into a single sequence
-    uint8_t rsdiv[qrcodegen_REED_SOLOMON_DEGREE_MAX];
-    reedSolomonComputeDivisor(blockEccLen, rsdiv);
-    const uint8_t *dat = data;
+    uint8_t        rsdiv[qrcodegen_REED_SOLOMON_DEGREE_MAX];
+    const uint8_t *rsdivLogs = reedSolomonGetDivisorLogs(blockEccLen, rsdiv);
+    const uint8_t *dat       = data;
     for (int i = 0; i < numBlocks; i++) {
         int      datLen = shortBlockDataLen + (i < numShortBlocks ? 0 : 1);
         uint8_t *ecc    = &data[dataLen];  // Temporary storage
-        reedSolomonComputeRemainder(dat, datLen, rsdiv, blockEccLen, ecc);
+        reedSolomonComputeRemainderLogs(dat, datLen, rsdivLogs, blockEccLen, ecc);
         for (int j = 0, k = i; j < datLen; j++, k += numBlocks) {  // Copy data
             if (j == shortBlockDataLen) {
                 k -= numShortBlocks;
@@ -428,8 +502,8 @@ testable int getNumRawDataModules(int ver)
 /*---- Reed-Solomon ECC generator functions ----*/
 
 // Computes a Reed-Solomon ECC generator polynomial for the given degree, storing in result[0 :
-// degree]. This could be implemented as a lookup table over all possible parameter values, instead
-// of as an algorithm.
+// degree]. The generators used by the supported versions are also available as a lookup table,
+// see reedSolomonGetDivisorLogs().
 testable void reedSolomonComputeDivisor(int degree, uint8_t result[])
 {
     assert(1 <= degree && degree <= qrcodegen_REED_SOLOMON_DEGREE_MAX);
@@ -455,23 +529,68 @@ testable void reedSolomonComputeDivisor(int degree, uint8_t result[])
     }
 }
 
+#ifdef QRCODEGEN_TEST
 // Computes the Reed-Solomon error correction codeword for the given data and divisor polynomials.
 // The remainder when data[0 : dataLen] is divided by divisor[0 : degree] is stored in result[0 :
 // degree]. All polynomials are in big endian, and the generator has an implicit leading 1 term.
+// The encoder uses reedSolomonComputeRemainderLogs() directly, so this is only built for tests.
 testable void reedSolomonComputeRemainder(const uint8_t data[],
                                           int           dataLen,
                                           const uint8_t generator[],
                                           int           degree,
                                           uint8_t       result[])
+{
+    uint8_t generatorLogs[qrcodegen_REED_SOLOMON_DEGREE_MAX];
+
+    assert(1 <= degree && degree <= qrcodegen_REED_SOLOMON_DEGREE_MAX);
+    for (int j = 0; j < degree; j++) {
+        assert(generator[j] != 0);
+        generatorLogs[j] = GF_LOG[generator[j]];
+    }
+    reedSolomonComputeRemainderLogs(data, dataLen, generatorLogs, degree, result);
+}
+#endif  // QRCODEGEN_TEST
+
+// Returns the Reed-Solomon ECC generator polynomial for the given degree, with each coefficient
+// replaced by its logarithm. It is taken from RS_DIVISOR_LOGS if available, otherwise it is
+// computed in buffer[0 : degree].
+static const uint8_t *reedSolomonGetDivisorLogs(int degree, uint8_t buffer[])
 {
     assert(1 <= degree && degree <= qrcodegen_REED_SOLOMON_DEGREE_MAX);
+    if ((degree >= RS_DIVISOR_DEGREE_FIRST) && ((degree % 2) == 0)) {
+        return RS_DIVISOR_LOGS[(degree - RS_DIVISOR_DEGREE_FIRST) / 2];
+    }
+    reedSolomonComputeDivisor(degree, buffer);
+    for (int j = 0; j < degree; j++) {
+        assert(buffer[j] != 0);
+        buffer[j] = GF_LOG[buffer[j]];
+    }
+    return buffer;
+}
+
+// Same as reedSolomonComputeRemainder(), but with the coefficients of the generator given as
+// logarithms, so that each product is done with two table lookups.
+static void reedSolomonComputeRemainderLogs(const uint8_t data[],
+                                            int           dataLen,
+                                            const uint8_t generatorLogs[],
+                                            int           degree,
+                                            uint8_t       result[])
+{
     memset(result, 0, (size_t) degree * sizeof(result[0]));
     for (int i = 0; i < dataLen; i++) {  // Polynomial division
         uint8_t factor = data[i] ^ result[0];
         memmove(&result[0], &result[1], (size_t) (degree - 1) * sizeof(result[0]));
         result[degree - 1] = 0;
+        if (factor == 0) {
+            continue;
+        }
+        int factorLog = GF_LOG[factor];
         for (int j = 0; j < degree; j++) {
-            result[j] ^= reedSolomonMultiply(generator[j], factor);
+            int productLog = factorLog + generatorLogs[j];
+            if (productLog >= 255) {
+                productLog -= 255;
+            }
+            result[j] ^= GF_EXP[productLog];
         }
     }
 }
@@ -479,16 +598,17 @@ testable void reedSolomonComputeRemainder(const uint8_t data[],
 #undef qrcodegen_REED_SOLOMON_DEGREE_MAX
 
 // Returns the product of the two given field elements modulo GF(2^8/0x11D).
-// All inputs are valid. This could be implemented as a 256*256 lookup table.
+// All inputs are valid. The product is computed with the log/antilog tables.
 testable uint8_t reedSolomonMultiply(uint8_t x, uint8_t y)
 {
-    // Russian peasant multiplication
-    uint8_t z = 0;
-    for (int i = 7; i >= 0; i--) {
-        z = (uint8_t) ((z << 1) ^ ((z >> 7) * 0x11D));
-        z ^= ((y >> i) & 1) * x;
+    if ((x == 0) || (y == 0)) {
+        return 0;
+    }
+    int productLog = GF_LOG[x] + GF_LOG[y];
+    if (productLog >= 255) {
+        productLog -= 255;
     }
-    return z;
+    return GF_EXP[productLog];
 }
 
 /*---- Drawing function modules ----*/
@@ -750,19 +870,26 @@ static void applyMask(const uint8_t functionModules[], uint8_t qrcode[], enum qr
 
 // Calculates and returns the penalty score based on state of the given QR Code's current modules.
 // This is used by the automatic mask choice algorithm to find the mask pattern that yields the
-// lowest score.
-static long getPenaltyScore(const uint8_t qrcode[])
+// lowest score. As all the penalty terms are positive, the computation is stopped as soon as the
+// score reaches the given bound (the best score so far), and a value >= bound is then returned.
+static long getPenaltyScore(const uint8_t qrcode[], long bound)
 {
     int  qrsize = qrcodegen_getSize(qrcode);
     long result = 0;
+    int  dark   = 0;
 
     // Adjacent modules in row having same color, and finder-like patterns
+    // (dark modules are counted at the same time, for the balance)
     for (int y = 0; y < qrsize; y++) {
         bool runColor      = false;
         int  runX          = 0;
         int  runHistory[7] = {0};
         for (int x = 0; x < qrsize; x++) {
-            if (getModuleBounded(qrcode, x, y) == runColor) {
+            bool color = getModuleBounded(qrcode, x, y);
+            if (color) {
+                dark++;
+            }
+            if (color == runColor) {
                 runX++;
                 if (runX == 5) {
                     result += PENALTY_N1;
@@ -776,11 +903,14 @@ static long getPenaltyScore(const uint8_t qrcode[])
                 if (!runColor) {
                     result += finderPenaltyCountPatterns(runHistory, qrsize) * PENALTY_N3;
                 }
-                runColor = getModuleBounded(qrcode, x, y);
+                runColor = color;
                 runX     = 1;
             }
         }
         result += finderPenaltyTerminateAndCount(runColor, runX, runHistory, qrsize) * PENALTY_N3;
+        if (result >= bound) {
+            return result;
+        }
     }
     // Adjacent modules in column having same color, and finder-like patterns
     for (int x = 0; x < qrsize; x++) {
@@ -807,6 +937,9 @@ static long getPenaltyScore(const uint8_t qrcode[])
             }
         }
         result += finderPenaltyTerminateAndCount(runColor, runY, runHistory, qrsize) * PENALTY_N3;
+        if (result >= bound) {
+            return result;
+        }
     }
 
     // 2*2 blocks of modules having same color
@@ -819,17 +952,12 @@ static long getPenaltyScore(const uint8_t qrcode[])
                 result += PENALTY_N2;
             }
         }
+        if (result >= bound) {
+            return result;
+        }
     }
 
     // Balance of dark and light modules
-    int dark = 0;
-    for (int y = 0; y < qrsize; y++) {
-        for (int x = 0; x < qrsize; x++) {
-            if (getModuleBounded(qrcode, x, y)) {
-                dark++;
-            }
-        }
-    }
     int total = qrsize * qrsize;  // Note that size is odd, so dark/total != 1/2
     // Compute the smallest integer k >= 0 such that (45-5k)% <= dark/total <= (55+5k)%
     int k = (int) ((labs(dark * 20L - total * 10L) + total - 1) / total) - 1;
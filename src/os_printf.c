@@ -154,10 +154,44 @@ static const char g_pcHex_cap[] = {
 #ifdef HAVE_PRINTF
 #include "os_io_seph_cmd.h"
 
+// Size of the buffer in which the fragments of a PRINTF (literal parts, numbers, strings...) are
+// gathered, so that they are sent with a single command instead of one command per fragment
+#ifndef PRINTF_BUFFER_SIZE
+#define PRINTF_BUFFER_SIZE 128
+#endif  // PRINTF_BUFFER_SIZE
+
+// Context for printf
+typedef struct {
+    size_t len;
+    char   buffer[PRINTF_BUFFER_SIZE];
+} printf_ctx_t;
+
+static void printf_flush(printf_ctx_t *ctx)
+{
+    os_io_seph_cmd_printf(ctx->buffer, ctx->len);
+    ctx->len = 0;
+}
+
 static void printf_output(const char *data, size_t len, void *context)
 {
-    (void) context;
-    os_io_seph_cmd_printf(data, len);
+    printf_ctx_t *ctx = (printf_ctx_t *) context;
+
+    while (len > 0) {
+        size_t chunk = sizeof(ctx->buffer) - ctx->len;
+
+        if (chunk > len) {
+            chunk = len;
+        }
+        memcpy(&ctx->buffer[ctx->len], data, chunk);
+        ctx->len += chunk;
+        data += chunk;
+        len -= chunk;
+
+        // Only send the buffer when full, the end of the string is sent by mcu_usb_printf()
+        if (ctx->len == sizeof(ctx->buffer)) {
+            printf_flush(ctx);
+        }
+    }
 }
 #endif  // HAVE_PRINTF
 #endif  // BUILD_SCREENSHOTS
@@ -648,15 +682,22 @@ void screen_printf(const char *format, ...) __attribute__((weak, alias("mcu_usb_
 
 void mcu_usb_printf(const char *format, ...)
 {
-    va_list vaArgP;
+    va_list      vaArgP;
+    printf_ctx_t ctx;
 
     if (format == NULL) {
         return;
     }
 
+    ctx.len = 0;
     va_start(vaArgP, format);
-    (void) vformat_internal(printf_output, NULL, format, vaArgP);
+    (void) vformat_internal(printf_output, &ctx, format, vaArgP);
     va_end(vaArgP);
+
+    // Send what was formatted, even on format error
+    if (ctx.len > 0) {
+        printf_flush(&ctx);
+    }
 }
 
 #endif  // HAVE_PRINTF
@@ -21,6 +21,7 @@
 #include "nbgl_debug.h"
 #include "nbgl_driver.h"
 #include "nbgl_buttons.h"
+#include "nbgl_layout.h"
 
 /*********************
  *      DEFINES
@@ -77,6 +78,20 @@ void mainExit(int exitCode)
     exit(exitCode);
 }
 
+// prints the high-water marks of the objects pools, to help sizing them
+static void printPoolPeaks(void)
+{
+    for (uint8_t layer = 0; layer < NB_TRACKED_LAYERS; layer++) {
+        if (nbgl_layoutGetObjPoolPeak(layer) == 0) {
+            continue;
+        }
+        printf("Pools peak usage in layer %d: %d objects, %d container slots\n",
+               layer,
+               nbgl_layoutGetObjPoolPeak(layer),
+               nbgl_layoutGetContainerPoolPeak(layer));
+    }
+}
+
 /**
  * @brief Entry point of the simulator
  *
@@ -124,6 +139,7 @@ int main(int argc, char **argv)
 #endif                   // HAVE_SE_TOUCH
         if (res == 1) {  // normal end
             scenario_save_json();
+            printPoolPeaks();
             break;
         }
         else if (res == -1) {  // error
@@ -0,0 +1,312 @@
+#!/usr/bin/env python3
+# Compile the app with DEBUG_MEMORY_PROFILING_RING=1, read the dump with the default APDU
+# (CLA=0xB0, INS=0x59, P1-P2 = offset) until a short response, concatenate the responses in a
+# file (binary or hexadecimal) and feed it to this script:
+# ./memprof.py dump.bin --timeline --sites
+
+import struct
+import sys
+from argparse import ArgumentParser, Namespace, ArgumentDefaultsHelpFormatter, RawDescriptionHelpFormatter
+from dataclasses import dataclass, field
+from typing import Optional
+
+import valground
+
+OPS = ["init", "alloc", "persist", "free", "arena"]
+
+# Same as lib_alloc/mem_alloc.c. With HAVE_MEM_ALLOC_WIDE_HEADER, the heap header is bigger, and
+# the heaps which can't be addressed with the compact chunk headers use wide ones.
+HEAP_HEADER_SIZE = 96
+WIDE_BUILD_HEAP_HEADER_SIZE = 288
+ALLOC_CHUNK_HEADER_SIZE = 4
+WIDE_ALLOC_CHUNK_HEADER_SIZE = 8
+MAX_COMPACT_HEAP_DATA_SIZE = 0x7FF8
+MAX_WIDE_HEAP_DATA_SIZE = 0x1FFFF8
+
+# Same as lib_alloc/mem_profiling.c
+DUMP_FLAG_WIDE_HEADERS = 0x01
+
+
+# ===============================================================================
+#          Dump parsing
+# ===============================================================================
+@dataclass
+class Event:
+    op: str
+    site: str
+    addr: int
+    size: int
+
+
+@dataclass
+class Dump:
+    ring_size: int
+    total_events: int
+    wide_build: bool = False
+    events: list[Event] = field(default_factory=list)
+
+    @property
+    def truncated(self) -> bool:
+        return self.total_events > len(self.events)
+
+    @property
+    def heap_header_size(self) -> int:
+        return WIDE_BUILD_HEAP_HEADER_SIZE if self.wide_build else HEAP_HEADER_SIZE
+
+    @property
+    def max_heap_size(self) -> int:
+        if self.wide_build:
+            return MAX_WIDE_HEAP_DATA_SIZE + self.heap_header_size
+        return MAX_COMPACT_HEAP_DATA_SIZE + self.heap_header_size
+
+
+def parse_dump(data: bytes) -> Dump:
+    if data[:2] != b"MP":
+        raise ValueError("Not a memory profiling dump")
+    version, nb_sites, ring_size, nb_events, total_events = struct.unpack(">BBHHI", data[2:12])
+    if version not in (1, 2):
+        raise ValueError(f"Unsupported dump version {version}")
+    dump = Dump(ring_size, total_events)
+    offset = 12
+    if version >= 2:
+        # version 1 dumps had no flags, and were only produced with the compact headers
+        dump.wide_build = bool(data[offset] & DUMP_FLAG_WIDE_HEADERS)
+        offset += 1
+
+    sites = []
+    for _ in range(nb_sites):
+        line, length = struct.unpack(">HB", data[offset:offset + 3])
+        offset += 3
+        name = data[offset:offset + length].decode(errors="replace")
+        offset += length
+        sites.append(f"{name}:{line}" if name else "")
+
+    for _ in range(nb_events):
+        op, site, addr, size = struct.unpack(">BBII", data[offset:offset + 10])
+        offset += 10
+        site_name = sites[site] if site < len(sites) else "unknown"
+        dump.events.append(Event(OPS[op], site_name, addr, size))
+    return dump
+
+
+def read_dump(path: str) -> bytes:
+    with open(path, "rb") as f:
+        data = f.read()
+    # Hexadecimal dumps (as printed by most APDU clients) are accepted too
+    try:
+        return bytes.fromhex(data.decode().replace("\n", "").replace(" ", ""))
+    except ValueError:
+        return data
+
+
+# ===============================================================================
+#          Heap model
+# ===============================================================================
+def block_size(size: int, wide: bool) -> int:
+    # Same as align_alloc_size() in lib_alloc/mem_alloc.c: header and alignment included
+    if wide:
+        return ((size + 7) & ~7) + WIDE_ALLOC_CHUNK_HEADER_SIZE
+    size = (size + 3) & ~3
+    return size + (ALLOC_CHUNK_HEADER_SIZE if size & 4 else ALLOC_CHUNK_HEADER_SIZE + 4)
+
+
+@dataclass
+class SiteStats:
+    nb_allocs: int = 0
+    allocated: int = 0
+    live: int = 0
+    max_live: int = 0
+    pinned: int = 0
+
+
+@dataclass
+class Segment:
+    """Live chunks between two heap initializations"""
+    heap_addr: int
+    heap_size: int
+    header_size: int
+    live: dict[int, Event] = field(default_factory=dict)
+
+    @property
+    def wide(self) -> bool:
+        """Same as mem_init(): the compact chunk headers are kept for the heaps they can address"""
+        return self.heap_size > MAX_COMPACT_HEAP_DATA_SIZE + self.header_size
+
+    def block_size(self, size: int) -> int:
+        return block_size(size, self.wide)
+
+    def free_gaps(self) -> list[tuple[int, int, Optional[Event]]]:
+        """Returns the free gaps of the heap as (start, size, live chunk just above)"""
+        gaps = []
+        start = self.heap_addr + self.header_size
+        chunk_header_size = WIDE_ALLOC_CHUNK_HEADER_SIZE if self.wide else ALLOC_CHUNK_HEADER_SIZE
+        for addr in sorted(self.live):
+            block = addr - chunk_header_size
+            if block > start:
+                gaps.append((start, block - start, self.live[addr]))
+            start = max(start, block + self.block_size(self.live[addr].size))
+        end = self.heap_addr + self.heap_size
+        if end > start:
+            gaps.append((start, end - start, None))
+        return gaps
+
+    def fragmentation(self) -> tuple[float, dict[str, int]]:
+        """Returns 1 - largest free gap / free bytes, and the free bytes pinned by each call-site.
+        A live chunk separating two free gaps pins the smaller one: this many bytes would join a
+        bigger free chunk if it were freed."""
+        gaps = self.free_gaps()
+        pinned: dict[str, int] = {}
+        for i, (start, size, above) in enumerate(gaps[:-1]):
+            if above is not None and gaps[i + 1][0] == start + size + self.block_size(above.size):
+                pinned[above.site] = pinned.get(above.site, 0) + min(size, gaps[i + 1][1])
+        free = sum(gap[1] for gap in gaps)
+        if free == 0:
+            return 0.0, pinned
+        return 1 - max(gap[1] for gap in gaps) / free, pinned
+
+
+# ===============================================================================
+#          Reports
+# ===============================================================================
+def summary(dump: Dump, quiet: bool) -> bool:
+    """valground-style summary: leaks, free errors, persistent allocations, arenas"""
+    valground.COLORS = valground.init_colors(False)
+    mem: Optional[valground.Memory] = None
+    ret = True
+    for event in dump.events:
+        if event.op == "init":
+            if mem is not None and mem.summary(quiet, True) is False:
+                ret = False
+            mem = valground.Memory(event.addr, event.size, "")
+        elif mem is None:
+            # The oldest events, including the heap initialization, were overwritten: assume the
+            # biggest heap
+            mem = valground.Memory(0, dump.max_heap_size, "")
+        if event.op in ("alloc", "persist"):
+            if event.addr != 0:
+                mem.alloc(event.addr, event.size, event.site, event.op == "persist")
+        elif event.op == "free":
+            if dump.truncated and event.addr not in mem.allocs and event.addr not in mem.persists:
+                # allocated before the oldest event of the dump
+                continue
+            mem.free(event.addr, event.site)
+        elif event.op == "arena":
+            size = mem.allocs[event.addr].size if event.addr in mem.allocs else event.size
+            mem.arena(event.addr, size, event.size, event.site)
+    if mem is not None and mem.summary(quiet) is False:
+        ret = False
+    return ret
+
+
+def timeline(dump: Dump, width: int = 50) -> None:
+    """Heap usage (requested bytes) after each event, with the peak marked"""
+    print("\n=== Timeline ===")
+    usage = []
+    live: dict[int, int] = {}
+    current = 0
+    heap_size = 0
+    for event in dump.events:
+        if event.op == "init":
+            live.clear()
+            current = 0
+            heap_size = event.size
+        elif event.op in ("alloc", "persist") and event.addr != 0:
+            live[event.addr] = event.size
+            current += event.size
+        elif event.op == "free" and event.addr in live:
+            current -= live.pop(event.addr)
+        usage.append(current)
+    if not usage:
+        return
+    peak = max(usage)
+    scale = max(heap_size, peak, 1)
+    first = dump.total_events - len(dump.events)
+    for index, (event, current) in enumerate(zip(dump.events, usage)):
+        bar = "#" * (current * width // scale)
+        mark = " <- peak" if current == peak else ""
+        print(f"{first + index:6d} {event.op:7s} {current:6d} |{bar:{width}s}| {event.site}{mark}")
+
+
+def sites(dump: Dump) -> None:
+    """Per call-site statistics, with the free bytes pinned at the worst fragmentation"""
+    stats: dict[str, SiteStats] = {}
+    segment: Optional[Segment] = None
+    worst = (0.0, -1)
+
+    first = dump.total_events - len(dump.events)
+    for index, event in enumerate(dump.events):
+        if event.op == "init":
+            segment = Segment(event.addr, event.size, dump.heap_header_size)
+            continue
+        if segment is None:
+            # the heap bounds are unknown
+            continue
+        if event.op in ("alloc", "persist") and event.addr != 0:
+            site = stats.setdefault(event.site, SiteStats())
+            site.nb_allocs += 1
+            site.allocated += event.size
+            site.live += event.size
+            site.max_live = max(site.max_live, site.live)
+            segment.live[event.addr] = event
+        elif event.op == "free" and event.addr in segment.live:
+            freed = segment.live.pop(event.addr)
+            stats[freed.site].live -= freed.size
+        fragmentation, pinned = segment.fragmentation()
+        if fragmentation > worst[0]:
+            worst = (fragmentation, first + index)
+            for name, site in stats.items():
+                site.pinned = pinned.get(name, 0)
+
+    print("\n=== Call-sites ===")
+    print(f"{'allocs':>7s} {'bytes':>8s} {'max live':>8s} {'live':>6s} {'pinned':>6s}  site")
+    for name, site in sorted(stats.items(), key=lambda item: -item[1].pinned):
+        print(f"{site.nb_allocs:7d} {site.allocated:8d} {site.max_live:8d} {site.live:6d} "
+              f"{site.pinned:6d}  {name or 'unknown'}")
+    if worst[1] >= 0:
+        print(f"Worst fragmentation (1 - largest free gap / free bytes) = {worst[0]:.02%}, "
+              f"after event {worst[1]}: pinned bytes are given at this point")
+
+
+# ===============================================================================
+#          Parameters
+# ===============================================================================
+class CustomFormatter(ArgumentDefaultsHelpFormatter, RawDescriptionHelpFormatter):
+    """Custom formatter that combines ArgumentDefaultsHelpFormatter and RawDescriptionHelpFormatter"""
+    pass
+
+
+def init_parser() -> Namespace:
+    """Initialize the argument parser for command line arguments"""
+    epilog = "Compile the app with DEBUG_MEMORY_PROFILING_RING=1 and read the dump with the default APDU.\n"
+    epilog += "Example usage: ./memprof.py dump.bin --timeline --sites"
+    parser = ArgumentParser(description="Decode the memory profiling ring buffer.",
+                            formatter_class=CustomFormatter,
+                            epilog=epilog)
+    parser.add_argument("dump", help="Dump file (binary, or hexadecimal text).")
+    parser.add_argument("--quiet", "-q", action='store_true', help="Quiet logs to minimum.")
+    parser.add_argument("--timeline", "-t", action='store_true', help="Print the heap usage timeline.")
+    parser.add_argument("--sites", "-s", action='store_true', help="Print the per call-site report.")
+    return parser.parse_args()
+
+
+# ===============================================================================
+#          Main entry
+# ===============================================================================
+def main() -> None:
+    args = init_parser()
+    dump = parse_dump(read_dump(args.dump))
+
+    print(f"{len(dump.events)} events (ring of {dump.ring_size}), {dump.total_events} logged")
+    if dump.truncated:
+        print("Warning: the oldest events were overwritten, leaks may not be accurate")
+
+    ret_code = 0 if summary(dump, args.quiet) else 1
+    if args.timeline:
+        timeline(dump)
+    if args.sites:
+        sites(dump)
+    sys.exit(ret_code)
+
+
+if __name__ == "__main__":
+    main()
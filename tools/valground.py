@@ -37,12 +37,25 @@ class Allocation:
         self.code_location = code_location
 
 
+# ===============================================================================
+#          Arena class
+# ===============================================================================
+class Arena:
+    size: int
+    high_water: int
+
+    def __init__(self, size: int):
+        self.size = size
+        self.high_water = 0
+
+
 # ===============================================================================
 #          Memory class
 # ===============================================================================
 class Memory:
     allocs: dict[Allocation]
     persists: dict[Allocation]
+    arenas: dict[Arena]
     allocd_overtime: int
     allocd_max: int
     allocd_current: int
@@ -60,6 +73,7 @@ class Memory:
     def __init__(self, addr: int, size: int, test_name: str) -> None:
         self.allocs = {}
         self.persists = {}
+        self.arenas = {}
         self.allocd_overtime = 0
         self.allocd_max = 0
         self.allocd_current = 0
@@ -90,6 +104,14 @@ class Memory:
             self.allocd_current -= self.persists[ptr].size
             del self.persists[ptr]
 
+    def arena(self, ptr: int, size: int, high_water: int, code_loc: str) -> None:
+        # Arenas are reported by the location of the allocation of their backing buffer
+        if ptr in self.allocs:
+            code_loc = self.allocs[ptr].code_location
+        if code_loc not in self.arenas:
+            self.arenas[code_loc] = Arena(size)
+        self.arenas[code_loc].high_water = max(self.arenas[code_loc].high_water, high_water)
+
     def summary(self, quiet: bool = False, reclaimed_by_reset: bool = False) -> bool:
         # Print the test name on its first summary only (see printed_test_name above): this keeps
         # the name attached to that test's first content-bearing segment rather than landing on a
@@ -150,6 +172,10 @@ class Memory:
                     print(f"- {info.size} bytes from {info.code_location}")
                     del self.persists[addr]
                 print(f"{COLORS['all_reset']}", end='')
+            if len(self.arenas) > 0:
+                print("Arenas high-water marks:")
+                for code_loc, info in self.arenas.items():
+                    print(f"- {info.high_water}/{info.size} bytes from {code_loc}")
 
         # Free errors (free without malloc / double free) always fail. Leaks fail at the final
         # summary and at a test boundary (a new test had to reset the heap to reclaim them); leaks
@@ -278,6 +304,8 @@ def main() -> None:
                         mem.alloc(addr, int(words[1], base=0), words[3], words[0] == "persist")
                 elif words[0] == "free":
                     mem.free(int(words[1], base=0), words[2])
+                elif words[0] == "arena":
+                    mem.arena(int(words[3], base=0), int(words[1], base=0), int(words[2], base=0), words[4])
                 else:
                     assert False
 
@@ -5,6 +5,12 @@ set -e
 
 BUILD_DIRECTORY=$(realpath build/)
 
+# Benchmarks (e.g. transport) are built optimized, without coverage instrumentation
+if [ -z "$(find "${BUILD_DIRECTORY}" -name '*.gcno' -print -quit)" ]; then
+    echo "No coverage data in ${BUILD_DIRECTORY}, skipped."
+    exit 0
+fi
+
 lcov --directory . -b "${BUILD_DIRECTORY}" --capture --initial -o coverage.base &&
 lcov --rc lcov_branch_coverage=1 --directory . -b "${BUILD_DIRECTORY}" --capture -o coverage.capture &&
 lcov --directory . -b "${BUILD_DIRECTORY}" --add-tracefile coverage.base --add-tracefile coverage.capture -o coverage.info &&
@@ -0,0 +1,276 @@
+/**
+ * Host benchmark of mem_realloc.
+ *
+ * A set of buffers is grown by small steps, as a string builder or a TLV accumulator would do,
+ * while short-lived buffers are allocated and freed in between. The same workload is run twice:
+ * - with mem_realloc, which grows the buffers in place when a neighbour chunk is free,
+ * - with an explicit allocate, copy and free sequence, as a reference.
+ *
+ * The content of every buffer is checked after each step, so the benchmark also acts as a
+ * regression test: the exit code is not 0 if any buffer is corrupted.
+ *
+ * Reported figures:
+ * - number of grow operations, failed ones (heap full), and moved buffers,
+ * - bytes copied because of the moves,
+ * - final fragmentation of the heap (number of free chunks),
+ * - wall-clock time per grow operation.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "exceptions.h"
+#include "mem_alloc.h"
+
+/* Private defines------------------------------------------------------------*/
+#define BENCH_HEAP_SIZE   (16 * 1024)
+#define BENCH_MAX_BUFFERS 64
+
+/* Private types, structures, unions -----------------------------------------*/
+typedef struct bench_config_s {
+    uint32_t nb_steps;
+    uint32_t nb_buffers;
+    uint32_t max_step;  ///< max number of bytes added to a buffer at each step
+    uint32_t max_size;  ///< size from which a buffer is freed and started again
+    uint32_t seed;
+} bench_config_t;
+
+typedef struct bench_stats_s {
+    uint32_t nb_grows;
+    uint32_t nb_failed;
+    uint32_t nb_moves;
+    uint32_t nb_corrupted;
+    uint64_t copied_bytes;
+    uint64_t grow_ns;  ///< wall-clock time spent growing the buffers
+} bench_stats_t;
+
+typedef struct bench_buffer_s {
+    uint8_t *data;
+    size_t   size;
+} bench_buffer_t;
+
+typedef void *(*bench_grow_t)(mem_ctx_t ctx, void *ptr, size_t old_size, size_t new_size);
+
+/* Private variables ---------------------------------------------------------*/
+static uint64_t       bench_heap[BENCH_HEAP_SIZE / sizeof(uint64_t)];
+static bench_buffer_t bench_buffers[BENCH_MAX_BUFFERS];
+
+/* Private functions ---------------------------------------------------------*/
+// xorshift32, so that both runs see the same sequence on every host
+static uint32_t bench_rand(uint32_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint8_t bench_byte(size_t index, size_t offset)
+{
+    return (uint8_t) (index * 31 + offset);
+}
+
+static bool bench_check(const bench_buffer_t *buffer, size_t index)
+{
+    for (size_t i = 0; i < buffer->size; i++) {
+        if (buffer->data[i] != bench_byte(index, i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void *grow_realloc(mem_ctx_t ctx, void *ptr, size_t old_size, size_t new_size)
+{
+    (void) old_size;
+    return mem_realloc(ctx, ptr, new_size);
+}
+
+static void *grow_copy(mem_ctx_t ctx, void *ptr, size_t old_size, size_t new_size)
+{
+    void *new_ptr = mem_alloc(ctx, new_size);
+
+    if (new_ptr == NULL) {
+        return NULL;
+    }
+    memcpy(new_ptr, ptr, old_size);
+    mem_free(ctx, ptr);
+    return new_ptr;
+}
+
+static int bench_run(const char *name, bench_grow_t grow, const bench_config_t *config)
+{
+    bench_stats_t stats = {0};
+    mem_stat_t    stat;
+    uint32_t      state = config->seed;
+    mem_ctx_t     ctx   = mem_init(bench_heap, sizeof(bench_heap));
+
+    memset(bench_buffers, 0, sizeof(bench_buffers));
+    for (uint32_t step = 0; step < config->nb_steps; step++) {
+        size_t          index  = bench_rand(&state) % config->nb_buffers;
+        bench_buffer_t *buffer = &bench_buffers[index];
+        size_t          length = 1 + bench_rand(&state) % config->max_step;
+        // short-lived buffer, allocated between two grow operations
+        void *temp = mem_alloc(ctx, 1 + bench_rand(&state) % (2 * config->max_step));
+
+        if (buffer->size + length > config->max_size) {
+            mem_free(ctx, buffer->data);
+            buffer->data = NULL;
+            buffer->size = 0;
+        }
+        if (buffer->data == NULL) {
+            buffer->data = mem_alloc(ctx, length);
+            if (buffer->data == NULL) {
+                stats.nb_failed++;
+                mem_free(ctx, temp);
+                continue;
+            }
+        }
+        else {
+            uint64_t start    = bench_now_ns();
+            uint8_t *new_data = grow(ctx, buffer->data, buffer->size, buffer->size + length);
+
+            stats.grow_ns += bench_now_ns() - start;
+            stats.nb_grows++;
+            if (new_data == NULL) {
+                stats.nb_failed++;
+                mem_free(ctx, temp);
+                continue;
+            }
+            if (new_data != buffer->data) {
+                stats.nb_moves++;
+                stats.copied_bytes += buffer->size;
+            }
+            buffer->data = new_data;
+        }
+        for (size_t i = 0; i < length; i++) {
+            buffer->data[buffer->size + i] = bench_byte(index, buffer->size + i);
+        }
+        buffer->size += length;
+        if (!bench_check(buffer, index)) {
+            stats.nb_corrupted++;
+        }
+        mem_free(ctx, temp);
+    }
+
+    mem_stat(ctx, &stat);
+    printf("%-8s %8u %7u %7u %10llu %6u %7zu %9.1f %s\n",
+           name,
+           stats.nb_grows,
+           stats.nb_failed,
+           stats.nb_moves,
+           (unsigned long long) stats.copied_bytes,
+           stat.nb_chunks - stat.nb_allocated,
+           stat.free_size,
+           stats.nb_grows ? (double) stats.grow_ns / stats.nb_grows : 0.0,
+           stats.nb_corrupted ? "FAILED" : "OK");
+    if (stats.nb_corrupted) {
+        fprintf(stderr, "%s: %u corrupted buffer(s)\n", name, stats.nb_corrupted);
+    }
+
+    return stats.nb_corrupted ? 1 : 0;
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  --steps <n>                     number of grow steps (default: 100000)\n");
+    printf("  --buffers <n>                   number of growing buffers (default: 8, max: %u)\n",
+           BENCH_MAX_BUFFERS);
+    printf("  --step-size <n>                 max bytes added at each step (default: 32)\n");
+    printf("  --max-size <n>                  size from which a buffer is restarted "
+           "(default: 1024)\n");
+    printf("  --seed <n>                      seed of the workload generator (default: 1)\n");
+}
+
+/* Exported functions --------------------------------------------------------*/
+// Thrown by the allocator on a corrupted heap
+void os_longjmp(unsigned int exception)
+{
+    fprintf(stderr, "heap corrupted (exception 0x%x)\n", exception);
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option options[] = {
+        {"steps",     required_argument, NULL, 'n'},
+        {"buffers",   required_argument, NULL, 'b'},
+        {"step-size", required_argument, NULL, 's'},
+        {"max-size",  required_argument, NULL, 'm'},
+        {"seed",      required_argument, NULL, 'e'},
+        {"help",      no_argument,       NULL, 'h'},
+        {NULL,        0,                 NULL, 0  },
+    };
+    bench_config_t config = {
+        .nb_steps   = 100000,
+        .nb_buffers = 8,
+        .max_step   = 32,
+        .max_size   = 1024,
+        .seed       = 1,
+    };
+    int opt;
+    int status = 0;
+
+    while ((opt = getopt_long(argc, argv, "h", options, NULL)) != -1) {
+        switch (opt) {
+            case 'n':
+                config.nb_steps = strtoul(optarg, NULL, 0);
+                break;
+            case 'b':
+                config.nb_buffers = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                config.max_step = strtoul(optarg, NULL, 0);
+                break;
+            case 'm':
+                config.max_size = strtoul(optarg, NULL, 0);
+                break;
+            case 'e':
+                config.seed = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+    if ((config.nb_buffers == 0) || (config.nb_buffers > BENCH_MAX_BUFFERS)
+        || (config.max_step == 0) || (config.seed == 0)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    printf("heap %u bytes, %u buffers, steps of 1 to %u bytes, restarted from %u bytes\n",
+           BENCH_HEAP_SIZE,
+           config.nb_buffers,
+           config.max_step,
+           config.max_size);
+    printf("%-8s %8s %7s %7s %10s %6s %7s %9s\n",
+           "grow",
+           "grows",
+           "failed",
+           "moves",
+           "copied_B",
+           "frags",
+           "free_B",
+           "ns/grow");
+
+    status |= bench_run("realloc", grow_realloc, &config);
+    status |= bench_run("copy", grow_copy, &config);
+
+    return status;
+}
@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "mem_alloc.h"
+#include "mem_arena.h"
 #include "app_mem_utils.h"
 #include "errors.h"
 
@@ -77,6 +78,102 @@ static void test_alloc(void **state __attribute__((unused)))
     assert_null(chunk1);
 }
 
+static void test_good_fit(void **state __attribute__((unused)))
+{
+    malloc_buffer_size = sizeof(malloc_buffer);
+    mem_ctx_t ctx      = mem_init(malloc_buffer, malloc_buffer_size);
+
+    // chunks of 216 and 248 bytes (headers included), in 2 different sub-segments of
+    // [128:256[, separated by allocated chunks to avoid coalescing when freed
+    char *chunk1 = mem_alloc(ctx, 212);
+    char *sep1   = mem_alloc(ctx, 12);
+    char *chunk2 = mem_alloc(ctx, 244);
+    char *sep2   = mem_alloc(ctx, 12);
+    assert_non_null(chunk1);
+    assert_non_null(sep1);
+    assert_non_null(chunk2);
+    assert_non_null(sep2);
+    mem_free(ctx, chunk1);
+    mem_free(ctx, chunk2);
+    assert_state(ctx, 5, 2);
+
+    // a 200 bytes chunk fits in the 216 bytes one, even if not all chunks of its sub-segment
+    // would be big enough
+    char *chunk3 = mem_alloc(ctx, 196);
+    assert_ptr_equal(chunk3, chunk1);
+    // a 248 bytes chunk fits exactly in the 248 bytes one
+    char *chunk4 = mem_alloc(ctx, 244);
+    assert_ptr_equal(chunk4, chunk2);
+    // nothing left in [128:256[, so taken from the remaining big chunk
+    char *chunk5 = mem_alloc(ctx, 196);
+    assert_true(chunk5 > sep2);
+
+    mem_free(ctx, chunk3);
+    mem_free(ctx, chunk4);
+    mem_free(ctx, chunk5);
+    mem_free(ctx, sep1);
+    mem_free(ctx, sep2);
+    assert_state(ctx, 1, 0);
+}
+
+static void test_permanent(void **state __attribute__((unused)))
+{
+    mem_stat_t mapping;
+    malloc_buffer_size = sizeof(malloc_buffer);
+    mem_ctx_t ctx      = mem_init(malloc_buffer, malloc_buffer_size);
+
+    char *chunk1 = mem_alloc(ctx, 12);
+    // permanent chunks (16 and 128 bytes) are stacked downwards from the top of the heap
+    char *perm1  = mem_alloc_permanent(ctx, 12);
+    char *perm2  = mem_alloc_permanent(ctx, 120);
+    char *chunk2 = mem_alloc(ctx, 12);
+    assert_non_null(perm1);
+    assert_non_null(perm2);
+    assert_ptr_equal(perm1 + 12, ((char *) malloc_buffer) + malloc_buffer_size);
+    assert_ptr_equal(perm2 + 128, perm1);
+    assert_true(chunk2 < perm2);
+    assert_state(ctx, 5, 4);
+    mem_stat(ctx, &mapping);
+    assert_int_equal(mapping.permanent_size, 16 + 128);
+    assert_int_equal(mapping.transient_size, malloc_buffer_size - 96 - 16 - 128);
+
+    // permanent chunks can be neither freed nor resized
+    mem_free(ctx, perm1);
+    assert_null(mem_realloc(ctx, perm2, 12));
+    assert_state(ctx, 5, 4);
+
+    // freeing transient chunks leaves a single free chunk below the permanent region
+    mem_free(ctx, chunk1);
+    mem_free(ctx, chunk2);
+    assert_state(ctx, 3, 2);
+
+    // the whole free chunk can be taken
+    char *perm3 = mem_alloc_permanent(ctx, malloc_buffer_size - 96 - 16 - 128 - 4);
+    assert_ptr_equal(perm3, ((char *) malloc_buffer) + 96 + 4);
+    assert_state(ctx, 3, 3);
+    mem_stat(ctx, &mapping);
+    assert_int_equal(mapping.transient_size, 0);
+    assert_null(mem_alloc(ctx, 12));
+    assert_null(mem_alloc_permanent(ctx, 12));
+
+    // when the chunk below the region is allocated, a regular chunk is used
+    ctx          = mem_init(malloc_buffer, malloc_buffer_size);
+    char *chunk3 = mem_alloc(ctx, malloc_buffer_size - 96 - 4);
+    assert_non_null(chunk3);
+    assert_null(mem_alloc_permanent(ctx, 12));
+    chunk3      = mem_realloc(ctx, chunk3, 12);
+    char *perm4 = mem_alloc_permanent(ctx, 12);
+    assert_ptr_equal(perm4 + 12, ((char *) malloc_buffer) + malloc_buffer_size);
+    char *chunk4 = mem_alloc(ctx, malloc_buffer_size - 96 - 16 - 16 - 4);
+    assert_non_null(chunk4);
+    char *perm5 = mem_alloc_permanent(ctx, 12);
+    assert_null(perm5);
+    mem_free(ctx, chunk4);
+    assert_state(ctx, 3, 2);
+    mem_stat(ctx, &mapping);
+    assert_int_equal(mapping.permanent_size, 16);
+}
+
 static void test_re_alloc(void **state __attribute__((unused)))
 {
     malloc_buffer_size = sizeof(malloc_buffer);
@@ -100,37 +197,35 @@ static void test_re_alloc(void **state __attribute__((unused)))
     // Reallocate to a bigger size
     char *chunk2 = mem_realloc(ctx, chunk1, 128);
     assert_non_null(chunk2);
+    assert_ptr_equal(chunk2, chunk1);
     /**
-     * Expect 3 chunks :
-     * - original from init,
-     * - allocated,
+     * Expect 2 chunks :
+     * - allocated, grown in place into the free chunk from init,
      * - free leftover.
      * Expect 1 allocated :
      * - the allocated chunk
      */
-    assert_state(ctx, 3, 1);
+    assert_state(ctx, 2, 1);
 
     // Reallocate to a smaller size but not enough to split
     char *chunk3 = mem_realloc(ctx, chunk2, 127);
     assert_non_null(chunk3);
     assert_ptr_equal(chunk3, chunk2);
     /**
-     * Expect 3 chunks :
-     * - original chunk from init,
+     * Expect 2 chunks :
      * - reallocated,
      * - free leftover (from previous realloc).
      * Expect 1 allocated :
      * - the reallocated chunk
      */
-    assert_state(ctx, 3, 1);
+    assert_state(ctx, 2, 1);
 
     // Reallocate to a smaller size
     char *chunk4 = mem_realloc(ctx, chunk3, 32);
     assert_non_null(chunk4);
     assert_ptr_equal(chunk4, chunk3);
     /**
-     * Expect 4 chunks :
-     * - original chunk from init,
+     * Expect 3 chunks :
      * - reallocated,
      * - split free leftover (from shrink optimization),
      * - free leftover (from previous realloc).
@@ -139,15 +234,15 @@ static void test_re_alloc(void **state __attribute__((unused)))
      *
      * Free function not called so no coalescing done.
      */
-    assert_state(ctx, 4, 1);
+    assert_state(ctx, 3, 1);
 
     // Reallocate with size 0 to free
     char *chunk5 = mem_realloc(ctx, chunk4, 0);
     assert_null(chunk5);
     /**
      * Expect 2 chunks :
-     * - original chunk from init,
-     * - free leftover coalesced.
+     * - freed chunk, coalesced with the split free leftover,
+     * - free leftover.
      * Expect 0 allocated.
      */
     assert_state(ctx, 2, 0);
@@ -157,9 +252,9 @@ static void test_re_alloc(void **state __attribute__((unused)))
     assert_non_null(chunk6);
     /**
      * Expect 3 chunks:
-     * - original from init,
-     * - free leftover coalesced (from previous realloc),
-     * - allocated
+     * - free chunk (freed by previous realloc), too small,
+     * - allocated,
+     * - free leftover
      * Expect 1 allocated :
      * - the allocated chunk
      */
@@ -170,15 +265,133 @@ static void test_re_alloc(void **state __attribute__((unused)))
     assert_null(chunk7);
     /**
      * Expect 3 chunks:
-     * - original from init,
-     * - free leftover coalesced (from previous realloc),
-     * - allocated
+     * - free chunk (freed by previous realloc), too small,
+     * - allocated,
+     * - free leftover
      * Expect 1 allocated :
      * - the allocated chunk (from previous realloc)
      */
     assert_state(ctx, 3, 1);
 }
 
+static void test_re_alloc_in_place(void **state __attribute__((unused)))
+{
+    malloc_buffer_size = sizeof(malloc_buffer);
+    mem_ctx_t ctx      = mem_init(malloc_buffer, malloc_buffer_size);
+
+    // chunks of 64 bytes, the last one keeps the big free chunk away
+    char *chunk1 = mem_alloc(ctx, 60);
+    char *chunk2 = mem_alloc(ctx, 60);
+    char *chunk3 = mem_alloc(ctx, 60);
+    char *chunk4 = mem_alloc(ctx, 60);
+    assert_non_null(chunk4);
+    for (int i = 0; i < 60; i++) {
+        chunk2[i] = i;
+    }
+
+    // the next chunk is free: chunk2 grows without moving
+    mem_free(ctx, chunk3);
+    assert_ptr_equal(mem_realloc(ctx, chunk2, 100), chunk2);
+    assert_state(ctx, 5, 3);
+    // both free chunks are needed: the data are moved to the beginning of chunk1
+    mem_free(ctx, chunk1);
+    char *chunk5 = mem_realloc(ctx, chunk2, 180);
+    assert_ptr_equal(chunk5, chunk1);
+    for (int i = 0; i < 60; i++) {
+        assert_int_equal(chunk5[i], i);
+    }
+    // chunk1, chunk2 and the 24 bytes left by the first realloc are merged, then split in 184
+    // allocated bytes and 8 free bytes
+    assert_state(ctx, 4, 2);
+    // nothing around is free anymore: moved to a new chunk
+    char *chunk6 = mem_realloc(ctx, chunk5, 300);
+    assert_true(chunk6 > chunk4);
+    for (int i = 0; i < 60; i++) {
+        assert_int_equal(chunk6[i], i);
+    }
+
+    mem_free(ctx, chunk4);
+    mem_free(ctx, chunk6);
+    assert_state(ctx, 1, 0);
+}
+
+static void test_handles(void **state __attribute__((unused)))
+{
+    malloc_buffer_size = sizeof(malloc_buffer);
+    mem_ctx_t ctx      = mem_init(malloc_buffer, malloc_buffer_size);
+    char     *heap     = (char *) malloc_buffer;
+
+    // the handle table must be allocated first, and only once
+    assert_int_equal(mem_handle_alloc(ctx, 60), MEM_INVALID_HANDLE);
+    assert_false(mem_handles_init(ctx, 0));
+    assert_true(mem_handles_init(ctx, 4));
+    assert_false(mem_handles_init(ctx, 4));
+
+    // chunks of 64 bytes, below the big free chunk and the table (24 bytes)
+    char        *chunk1  = mem_alloc(ctx, 60);
+    mem_handle_t handle1 = mem_handle_alloc(ctx, 60);
+    char        *chunk2  = mem_alloc(ctx, 60);
+    mem_handle_t handle2 = mem_handle_alloc(ctx, 60);
+    mem_handle_t handle3 = mem_handle_alloc(ctx, 60);
+    char        *chunk3  = mem_alloc(ctx, 60);
+    assert_non_null(chunk3);
+    assert_int_not_equal(handle3, MEM_INVALID_HANDLE);
+    assert_state(ctx, 8, 7);
+    mem_handle_t handles[] = {handle1, handle2, handle3};
+    for (int h = 0; h < 3; h++) {
+        char *ptr = mem_handle_lock(ctx, handles[h]);
+        for (int i = 0; i < 60; i++) {
+            ptr[i] = h + i;
+        }
+        mem_handle_unlock(ctx, handles[h]);
+    }
+
+    // handle3 is locked: only handle1 and handle2 slide down, the free chunks are merged below
+    // handle3
+    mem_free(ctx, chunk1);
+    mem_free(ctx, chunk2);
+    char *ptr3 = mem_handle_lock(ctx, handle3);
+    assert_int_equal(mem_compact(ctx), malloc_buffer_size - 96 - 24 - 6 * 64 - 4);
+    assert_ptr_equal(mem_handle_lock(ctx, handle1), heap + 96 + 4);
+    assert_ptr_equal(mem_handle_lock(ctx, handle2), heap + 96 + 64 + 4);
+    assert_ptr_equal(mem_handle_lock(ctx, handle3), ptr3);
+    mem_handle_unlock(ctx, handle1);
+    mem_handle_unlock(ctx, handle2);
+    mem_handle_unlock(ctx, handle3);
+    mem_handle_unlock(ctx, handle3);
+    assert_state(ctx, 7, 5);
+
+    // once unlocked, handle3 slides down too, and all the free chunks are merged
+    mem_free(ctx, chunk3);
+    assert_int_equal(mem_compact(ctx), malloc_buffer_size - 96 - 24 - 3 * 64 - 4);
+    assert_state(ctx, 5, 4);
+    char *chunk4 = mem_alloc(ctx, malloc_buffer_size - 96 - 24 - 3 * 64 - 4);
+    assert_non_null(chunk4);
+    mem_free(ctx, chunk4);
+    for (int h = 0; h < 3; h++) {
+        char *ptr = mem_handle_lock(ctx, handles[h]);
+        assert_ptr_equal(ptr, heap + 96 + h * 64 + 4);
+        for (int i = 0; i < 60; i++) {
+            assert_int_equal(ptr[i], h + i);
+        }
+    }
+
+    // no more handles
+    mem_handle_t handle4 = mem_handle_alloc(ctx, 12);
+    assert_int_not_equal(handle4, MEM_INVALID_HANDLE);
+    assert_int_equal(mem_handle_alloc(ctx, 12), MEM_INVALID_HANDLE);
+    // freed and invalid handles can't be locked
+    mem_handle_free(ctx, handle4);
+    assert_null(mem_handle_lock(ctx, handle4));
+    assert_null(mem_handle_lock(ctx, MEM_INVALID_HANDLE));
+    assert_null(mem_handle_lock(ctx, 5));
+    // even if locked, a handle can be freed
+    mem_handle_free(ctx, handle1);
+    mem_handle_free(ctx, handle2);
+    mem_handle_free(ctx, handle3);
+    assert_state(ctx, 2, 1);
+}
+
 static void test_corrupt_invalid(void **state __attribute__((unused)))
 {
     uint32_t throw_raised_code = 0;
@@ -334,6 +547,55 @@ static void test_alloc_oversized_request(void **state __attribute__((unused)))
 
 // New tests using app_mem_utils wrapper
 
+static void test_arena(void **state __attribute__((unused)))
+{
+    mem_arena_t arena;
+    malloc_buffer_size = sizeof(malloc_buffer);
+    mem_ctx_t ctx      = mem_init(malloc_buffer, malloc_buffer_size);
+
+    assert_true(mem_arena_begin(ctx, &arena, 64));
+    // only the backing buffer is allocated in the heap
+    assert_state(ctx, 2, 1);
+
+    // buffers are contiguous, aligned on 8 bytes, the first one possibly not at the start of the
+    // backing buffer (only aligned on 4 bytes)
+    char  *buf1 = mem_arena_alloc(&arena, 10);
+    char  *buf2 = mem_arena_alloc(&arena, 20);
+    size_t pad  = (uint8_t *) buf1 - arena.buffer;
+    assert_non_null(buf1);
+    assert_non_null(buf2);
+    assert_int_equal(((uintptr_t) buf1) & 7, 0);
+    assert_true(pad < 8);
+    assert_ptr_equal(buf2, buf1 + 16);
+    assert_int_equal(arena.offset, pad + 36);
+    assert_null(mem_arena_alloc(&arena, 0));
+    assert_null(mem_arena_alloc(&arena, 64 - pad - 40 + 1));
+    // the end of the backing buffer can be reached
+    char *buf3 = mem_arena_alloc(&arena, 64 - pad - 40);
+    assert_ptr_equal(buf3, buf1 + 40);
+    assert_int_equal(arena.offset, 64);
+    assert_null(mem_arena_alloc(&arena, 1));
+    assert_state(ctx, 2, 1);
+
+    // everything is released at once, the high-water mark is kept
+    mem_arena_reset(&arena);
+    assert_ptr_equal(mem_arena_alloc(&arena, 4), buf1);
+    assert_int_equal(arena.offset, pad + 4);
+    assert_int_equal(arena.high_water, 64);
+
+    mem_arena_end(ctx, &arena);
+    assert_null(arena.buffer);
+    assert_null(mem_arena_alloc(&arena, 4));
+    assert_state(ctx, 1, 0);
+    // ending twice is harmless
+    mem_arena_end(ctx, &arena);
+
+    // the backing buffer can't be allocated
+    assert_false(mem_arena_begin(ctx, &arena, malloc_buffer_size));
+    assert_null(mem_arena_alloc(&arena, 4));
+    assert_state(ctx, 1, 0);
+}
+
 static void test_utils_init(void **state __attribute__((unused)))
 {
     // Test successful initialization
@@ -404,6 +666,26 @@ static void test_utils_buffer_calloc(void **state __attribute__((unused)))
     assert_null(buffer);
 }
 
+static void test_utils_arena(void **state __attribute__((unused)))
+{
+    mem_arena_t arena;
+    mem_utils_init(malloc_buffer, sizeof(malloc_buffer));
+
+    assert_true(APP_MEM_ARENA_BEGIN(&arena, 256));
+    void *buffer = APP_MEM_ARENA_ALLOC(&arena, 100);
+    assert_non_null(buffer);
+    APP_MEM_ARENA_RESET(&arena);
+    assert_ptr_equal(APP_MEM_ARENA_ALLOC(&arena, 200), buffer);
+    assert_null(APP_MEM_ARENA_ALLOC(&arena, 100));
+    APP_MEM_ARENA_END(&arena);
+    assert_null(arena.buffer);
+
+    // the whole heap is available again
+    buffer = APP_MEM_ALLOC(sizeof(malloc_buffer) - 96 - 4);
+    assert_non_null(buffer);
+    APP_MEM_FREE(buffer);
+}
+
 static void test_utils_buffer_realloc(void **state __attribute__((unused)))
 {
     mem_utils_init(malloc_buffer, sizeof(malloc_buffer));
@@ -533,18 +815,24 @@ int main(int argc, char **argv)
 {
     const struct CMUnitTest tests[] = {// Original mem_alloc tests
                                        cmocka_unit_test(test_alloc),
+                                       cmocka_unit_test(test_good_fit),
+                                       cmocka_unit_test(test_permanent),
                                        cmocka_unit_test(test_re_alloc),
+                                       cmocka_unit_test(test_re_alloc_in_place),
+                                       cmocka_unit_test(test_handles),
                                        cmocka_unit_test(test_corrupt_invalid),
                                        cmocka_unit_test(test_corrupt_overflow),
                                        cmocka_unit_test(test_fragmentation),
                                        cmocka_unit_test(test_init),
                                        cmocka_unit_test(test_alloc_oversized_request),
+                                       cmocka_unit_test(test_arena),
                                        // New app_mem_utils tests
                                        cmocka_unit_test(test_utils_init),
                                        cmocka_unit_test(test_utils_basic_alloc),
                                        cmocka_unit_test(test_utils_zero_size),
                                        cmocka_unit_test(test_utils_buffer_allocate),
                                        cmocka_unit_test(test_utils_buffer_calloc),
+                                       cmocka_unit_test(test_utils_arena),
                                        cmocka_unit_test(test_utils_buffer_realloc),
                                        cmocka_unit_test(test_utils_buffer_zero_size),
                                        cmocka_unit_test(test_utils_strdup),
@@ -0,0 +1,163 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <string.h>
+
+#include <cmocka.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "mem_alloc.h"
+
+// Built with HAVE_MEM_ALLOC_WIDE_HEADER: heaps bigger than 32 kBytes use 8-byte chunk headers
+#define BIG_HEAP_SIZE   (128 * 1024)
+#define SMALL_HEAP_SIZE (4 * 1024)
+
+static uint64_t malloc_buffer[(BIG_HEAP_SIZE + 256) / sizeof(uint64_t)];
+
+// Wrapper function for throw
+void __wrap_os_longjmp(unsigned int error_code)
+{
+    (void) error_code;
+    fail();
+}
+
+typedef struct {
+    uint8_t *addr;
+    size_t   size;
+} chunk_info_t;
+
+// Finds the chunk containing the given address
+static bool find_chunk(void *data, uint8_t *addr, bool allocated, size_t size)
+{
+    chunk_info_t *info = data;
+
+    (void) allocated;
+    if ((info->addr >= addr) && (info->addr < addr + size)) {
+        info->addr = addr;
+        info->size = size;
+        return true;
+    }
+    return false;
+}
+
+static size_t chunk_size(mem_ctx_t ctx, void *ptr)
+{
+    chunk_info_t info = {.addr = ptr, .size = 0};
+
+    mem_parse(ctx, find_chunk, &info);
+    return info.size;
+}
+
+static void assert_state(mem_ctx_t ctx, uint32_t nb_chunks, uint32_t nb_allocs)
+{
+    mem_stat_t mapping;
+    mem_stat(ctx, &mapping);
+    assert_int_equal(mapping.nb_chunks, nb_chunks);
+    assert_int_equal(mapping.nb_allocated, nb_allocs);
+}
+
+static void test_wide_alloc(void **state __attribute__((unused)))
+{
+    mem_ctx_t ctx = mem_init(malloc_buffer, sizeof(malloc_buffer));
+    assert_non_null(ctx);
+    assert_state(ctx, 1, 0);
+
+    // chunks are 8-byte aligned, with an 8-byte header
+    uint8_t *chunk1 = mem_alloc(ctx, 12);
+    assert_non_null(chunk1);
+    assert_int_equal(((uintptr_t) chunk1) & 7, 0);
+    assert_int_equal(chunk_size(ctx, chunk1), 24);
+
+    // buffers bigger than 32 kBytes can be allocated
+    uint8_t *big1 = mem_alloc(ctx, 40000);
+    uint8_t *big2 = mem_alloc(ctx, 70000);
+    assert_non_null(big1);
+    assert_non_null(big2);
+    assert_int_equal(chunk_size(ctx, big1), 40000 + 8);
+    memset(big1, 0x11, 40000);
+    memset(big2, 0x22, 70000);
+    assert_state(ctx, 4, 3);
+
+    // but not more than the heap
+    assert_null(mem_alloc(ctx, BIG_HEAP_SIZE));
+
+    // freed chunks are coalesced (24 + 40008 bytes)
+    mem_free(ctx, big1);
+    mem_free(ctx, chunk1);
+    assert_state(ctx, 3, 1);
+    chunk1 = mem_alloc(ctx, 24 + 40008 - 8);
+    assert_non_null(chunk1);
+    assert_int_equal(chunk_size(ctx, chunk1), 24 + 40008);
+    mem_free(ctx, chunk1);
+
+    // a big buffer can be grown, and keeps its content
+    big2 = mem_realloc(ctx, big2, 100000);
+    assert_non_null(big2);
+    for (size_t i = 0; i < 70000; i++) {
+        assert_int_equal(big2[i], 0x22);
+    }
+    mem_free(ctx, big2);
+    assert_state(ctx, 1, 0);
+}
+
+static void test_wide_permanent(void **state __attribute__((unused)))
+{
+    mem_ctx_t ctx = mem_init(malloc_buffer, sizeof(malloc_buffer));
+
+    uint8_t *perm1 = mem_alloc_permanent(ctx, 50000);
+    assert_non_null(perm1);
+    assert_ptr_equal(perm1 + 50000, ((uint8_t *) malloc_buffer) + sizeof(malloc_buffer));
+    uint8_t *chunk1 = mem_alloc(ctx, 50000);
+    assert_non_null(chunk1);
+    assert_true(chunk1 < perm1);
+    mem_free(ctx, perm1);
+    mem_free(ctx, chunk1);
+    assert_state(ctx, 2, 1);
+}
+
+static void test_wide_handles(void **state __attribute__((unused)))
+{
+    mem_ctx_t ctx = mem_init(malloc_buffer, sizeof(malloc_buffer));
+
+    assert_true(mem_handles_init(ctx, 4));
+    void        *first   = mem_alloc(ctx, 40000);
+    mem_handle_t handle1 = mem_handle_alloc(ctx, 40000);
+    assert_non_null(first);
+    assert_int_not_equal(handle1, MEM_INVALID_HANDLE);
+    uint8_t *ptr = mem_handle_lock(ctx, handle1);
+    memset(ptr, 0x33, 40000);
+    mem_handle_unlock(ctx, handle1);
+
+    // the handle chunk slides down over the 40000 bytes freed below it
+    mem_free(ctx, first);
+    assert_true(mem_compact(ctx) > 40000);
+    uint8_t *moved = mem_handle_lock(ctx, handle1);
+    assert_true(moved < ptr);
+    for (size_t i = 0; i < 40000; i++) {
+        assert_int_equal(moved[i], 0x33);
+    }
+    mem_handle_unlock(ctx, handle1);
+    mem_handle_free(ctx, handle1);
+}
+
+static void test_compact_small_heap(void **state __attribute__((unused)))
+{
+    // small heaps keep the compact 4-byte headers
+    mem_ctx_t ctx = mem_init(malloc_buffer, SMALL_HEAP_SIZE);
+
+    uint8_t *chunk1 = mem_alloc(ctx, 12);
+    assert_non_null(chunk1);
+    assert_int_equal(chunk_size(ctx, chunk1), 16);
+    assert_null(mem_alloc(ctx, SMALL_HEAP_SIZE));
+    mem_free(ctx, chunk1);
+    assert_state(ctx, 1, 0);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_wide_alloc),
+                                       cmocka_unit_test(test_wide_permanent),
+                                       cmocka_unit_test(test_wide_handles),
+                                       cmocka_unit_test(test_compact_small_heap)};
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
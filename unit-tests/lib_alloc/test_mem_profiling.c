@@ -0,0 +1,133 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <string.h>
+
+#include <cmocka.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "app_mem_utils.h"
+#include "mem_profiling.h"
+#include "os_math.h"
+#include "os_utils.h"
+
+// Built with MEM_PROFILING_NB_EVENTS = 8 and MEM_PROFILING_NB_SITES = 4
+#define HEADER_SIZE 13
+#define EVENT_SIZE  10
+
+static uint32_t malloc_buffer[1024];
+
+// Wrapper function for throw
+void __wrap_os_longjmp(unsigned int error_code)
+{
+    (void) error_code;
+    fail();
+}
+
+static const uint8_t *get_event(const uint8_t *dump, size_t length, size_t index)
+{
+    return &dump[length - (dump[7] - index) * EVENT_SIZE];
+}
+
+static void assert_event(const uint8_t *event, uint8_t op, const void *addr, uint32_t size)
+{
+    assert_int_equal(event[0], op);
+    assert_int_equal(U4BE(event, 2), (uint32_t) (uintptr_t) addr);
+    assert_int_equal(U4BE(event, 6), size);
+}
+
+static void test_profiling_ring(void **state __attribute__((unused)))
+{
+    uint8_t     dump[512];
+    size_t      length;
+    mem_arena_t arena;
+
+    mem_utils_init(malloc_buffer, sizeof(malloc_buffer));
+    void *ptr1 = APP_MEM_ALLOC(10);
+    void *ptr2 = NULL;
+    assert_true(APP_MEM_PERMANENT(&ptr2, 20));
+    APP_MEM_FREE(ptr1);
+
+    length = mem_profiling_dump(0, dump, sizeof(dump));
+    assert_memory_equal(dump, "MP\x02", 3);
+    // init, alloc, persist and free sites
+    assert_int_equal(dump[3], 4);
+    assert_int_equal(U2BE(dump, 4), 8);
+    assert_int_equal(U2BE(dump, 6), 4);
+    assert_int_equal(U4BE(dump, 8), 4);
+    // compact chunk headers only
+    assert_int_equal(dump[12], 0);
+    assert_event(
+        get_event(dump, length, 0), MEM_PROFILING_OP_INIT, malloc_buffer, sizeof(malloc_buffer));
+    assert_event(get_event(dump, length, 1), MEM_PROFILING_OP_ALLOC, ptr1, 10);
+    assert_event(get_event(dump, length, 2), MEM_PROFILING_OP_PERSIST, ptr2, 20);
+    assert_event(get_event(dump, length, 3), MEM_PROFILING_OP_FREE, ptr1, 0);
+    // the first site (init) has no file name
+    assert_int_equal(U2BE(dump, HEADER_SIZE), 0);
+    assert_int_equal(dump[HEADER_SIZE + 2], 0);
+    // the end of the file names is kept
+    size_t name_length = MIN(strlen(__FILE__), MEM_PROFILING_FILE_NAME_LEN);
+    assert_int_equal(dump[HEADER_SIZE + 3 + 2], name_length);
+    assert_memory_equal(
+        &dump[HEADER_SIZE + 3 + 3], __FILE__ + strlen(__FILE__) - name_length, name_length);
+
+    // the dump can be read by chunks
+    uint8_t chunks[512];
+    size_t  chunk_length;
+    size_t  offset = 0;
+    do {
+        chunk_length = mem_profiling_dump(offset, &chunks[offset], 7);
+        offset += chunk_length;
+    } while (chunk_length == 7);
+    assert_int_equal(offset, length);
+    assert_memory_equal(chunks, dump, length);
+
+    // the oldest events are overwritten, the sites of the last ones are not recorded
+    assert_true(APP_MEM_ARENA_BEGIN(&arena, 64));
+    uint8_t *arena_buffer = arena.buffer;
+    assert_non_null(APP_MEM_ARENA_ALLOC(&arena, 40));
+    // the high-water mark includes the bytes skipped to align the buffer
+    size_t arena_high_water = arena.high_water;
+    APP_MEM_ARENA_RESET(&arena);
+    APP_MEM_ARENA_END(&arena);
+    ptr1 = APP_MEM_ALLOC(12);
+    APP_MEM_FREE(ptr1);
+    length = mem_profiling_dump(0, dump, sizeof(dump));
+    assert_int_equal(U2BE(dump, 6), 8);
+    assert_int_equal(U4BE(dump, 8), 10);
+    assert_event(get_event(dump, length, 0), MEM_PROFILING_OP_PERSIST, ptr2, 20);
+    assert_event(get_event(dump, length, 2), MEM_PROFILING_OP_ALLOC, arena_buffer, 64);
+    assert_event(get_event(dump, length, 3), MEM_PROFILING_OP_ARENA, arena_buffer, arena_high_water);
+    assert_int_equal(get_event(dump, length, 3)[1], MEM_PROFILING_UNKNOWN_SITE);
+    assert_event(get_event(dump, length, 7), MEM_PROFILING_OP_FREE, ptr1, 0);
+}
+
+static void test_profiling_realloc(void **state __attribute__((unused)))
+{
+    uint8_t dump[512];
+    size_t  length;
+
+    mem_utils_init(malloc_buffer, sizeof(malloc_buffer));
+    void *ptr1 = APP_MEM_ALLOC(10);
+    // the next chunk is free, so the buffer grows in place
+    void *ptr2 = APP_MEM_REALLOC(ptr1, 40);
+    assert_ptr_equal(ptr2, ptr1);
+
+    // the new size is recorded all the same (the ring also holds the events of the previous test)
+    length      = mem_profiling_dump(0, dump, sizeof(dump));
+    size_t last = dump[7] - 1;
+    assert_event(get_event(dump, length, last - 3),
+                 MEM_PROFILING_OP_INIT,
+                 malloc_buffer,
+                 sizeof(malloc_buffer));
+    assert_event(get_event(dump, length, last - 2), MEM_PROFILING_OP_ALLOC, ptr1, 10);
+    assert_event(get_event(dump, length, last - 1), MEM_PROFILING_OP_FREE, ptr1, 0);
+    assert_event(get_event(dump, length, last), MEM_PROFILING_OP_ALLOC, ptr2, 40);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_profiling_ring),
+                                       cmocka_unit_test(test_profiling_realloc)};
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -28,9 +28,104 @@ static void test_base58(void **state)
     assert_string_equal((char *) out2, expected_out2);
 }
 
+static void test_base58_leading_zeros(void **state)
+{
+    (void) state;
+
+    const uint8_t in[]    = {0x00, 0x00, 0x00, 0x01, 0x00};
+    char          out[20] = {0};
+    uint8_t       back[8] = {0};
+    int           out_len = base58_encode(in, sizeof(in), out, sizeof(out));
+    assert_int_equal(out_len, 5);
+    assert_memory_equal(out, "1115R", 5);
+    assert_int_equal(base58_decode(out, out_len, back, sizeof(back)), sizeof(in));
+    assert_memory_equal(back, in, sizeof(in));
+
+    // only zeros
+    assert_int_equal(base58_encode(in, 3, out, sizeof(out)), 3);
+    assert_memory_equal(out, "111", 3);
+    assert_int_equal(base58_decode("111", 3, back, sizeof(back)), 3);
+    assert_memory_equal(back, in, 3);
+}
+
+static void test_base58_errors(void **state)
+{
+    (void) state;
+
+    uint8_t out[100];
+    char    out2[100];
+
+    // invalid characters
+    assert_int_equal(base58_decode("1l", 2, out, sizeof(out)), -1);
+    assert_int_equal(base58_decode("2\xff", 2, out, sizeof(out)), -1);
+    // output buffer too small
+    assert_int_equal(base58_decode("USm3fpXnKG5EUBx2", 16, out, 11), -1);
+    assert_int_equal(base58_encode((const uint8_t *) "The quick", 9, out2, 12), -1);
+    // input too long
+    assert_int_equal(base58_encode(out, MAX_ENC_INPUT_SIZE + 1, out2, sizeof(out2)), -1);
+}
+
+static void test_base58_streaming(void **state)
+{
+    (void) state;
+
+    uint8_t          in[500];
+    char             encoded[700];
+    uint8_t          decoded[500];
+    uint32_t         enc_work[BASE58_ENCODE_WORK_LIMBS(sizeof(in))];
+    uint32_t         dec_work[BASE58_DECODE_WORK_LIMBS(sizeof(encoded))];
+    base58_encoder_t encoder;
+    base58_decoder_t decoder;
+    int              length;
+
+    for (size_t i = 0; i < sizeof(in); i++) {
+        in[i] = (uint8_t) (i * 167 + 13);
+    }
+    in[0] = 0;
+
+    // longer than MAX_ENC_INPUT_SIZE, fed in parts of various sizes
+    base58_encode_init(&encoder, enc_work, BASE58_ENCODE_WORK_LIMBS(sizeof(in)));
+    for (size_t offset = 0, part = 1; offset < sizeof(in); offset += part, part = part % 7 + 1) {
+        if (part > sizeof(in) - offset) {
+            part = sizeof(in) - offset;
+        }
+        assert_true(base58_encode_update(&encoder, &in[offset], part));
+    }
+    length = base58_encode_final(&encoder, encoded, sizeof(encoded));
+    assert_true(length > MAX_DEC_INPUT_SIZE);
+    assert_int_equal(encoded[0], '1');
+
+    // the first bytes give the same result as the one-shot encoding
+    char short_encoded[200];
+    char short_streamed[200];
+    int  short_length = base58_encode(in, MAX_ENC_INPUT_SIZE, short_encoded, sizeof(short_encoded));
+    base58_encode_init(&encoder, enc_work, BASE58_ENCODE_WORK_LIMBS(MAX_ENC_INPUT_SIZE));
+    assert_true(base58_encode_update(&encoder, in, MAX_ENC_INPUT_SIZE));
+    assert_int_equal(base58_encode_final(&encoder, short_streamed, sizeof(short_streamed)),
+                     short_length);
+    assert_memory_equal(short_streamed, short_encoded, short_length);
+
+    base58_decode_init(&decoder, dec_work, BASE58_DECODE_WORK_LIMBS(length));
+    assert_true(base58_decode_update(&decoder, encoded, 100));
+    assert_true(base58_decode_update(&decoder, encoded + 100, length - 100));
+    assert_int_equal(base58_decode_final(&decoder, decoded, sizeof(decoded)), sizeof(in));
+    assert_memory_equal(decoded, in, sizeof(in));
+
+    // workspace too small
+    base58_encode_init(&encoder, enc_work, BASE58_ENCODE_WORK_LIMBS(100));
+    assert_false(base58_encode_update(&encoder, in, sizeof(in)));
+    assert_int_equal(base58_encode_final(&encoder, encoded, sizeof(encoded)), -1);
+    base58_decode_init(&decoder, dec_work, BASE58_DECODE_WORK_LIMBS(100));
+    assert_false(base58_decode_update(&decoder, encoded, length));
+    assert_int_equal(base58_decode_final(&decoder, decoded, sizeof(decoded)), -1);
+}
+
 int main()
 {
-    const struct CMUnitTest tests[] = {cmocka_unit_test(test_base58)};
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_base58),
+                                       cmocka_unit_test(test_base58_leading_zeros),
+                                       cmocka_unit_test(test_base58_errors),
+                                       cmocka_unit_test(test_base58_streaming)};
 
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -50,6 +50,9 @@ static void test_format_u64(void **state)
 
     // buffer too small
     assert_false(format_u64(temp, sizeof(temp) - 5, value));
+    assert_false(format_u64(temp, 1, 7));
+    assert_true(format_u64(temp, 2, 7));
+    assert_string_equal(temp, "7");
 }
 
 static void test_format_fpu64(void **state)
@@ -110,6 +113,67 @@ static void test_format_fpu64_trimmed(void **state)
     memset(temp, 0, sizeof(temp));
     assert_true(format_fpu64_trimmed(temp, sizeof(temp), amount, 8));
     assert_string_equal(temp, "10");  // BTC
+
+    // no dot without decimals
+    assert_true(format_fpu64(temp, sizeof(temp), 1234, 0));
+    assert_string_equal(temp, "1234");
+    assert_true(format_fpu64_trimmed(temp, sizeof(temp), 1234, 0));
+    assert_string_equal(temp, "1234");
+}
+
+static void test_format_fpu64_small_buffer(void **state)
+{
+    (void) state;
+
+    char temp[22] = {0};
+
+    // a value below 10^decimals is never truncated
+    assert_true(format_fpu64(temp, 11, 100ull, 8));
+    assert_string_equal(temp, "0.00000100");
+    assert_false(format_fpu64(temp, 10, 100ull, 8));
+    assert_false(format_fpu64(temp, 9, 100ull, 8));
+
+    // only the trimmed amount has to fit
+    assert_true(format_fpu64_trimmed(temp, 9, 100ull, 8));
+    assert_string_equal(temp, "0.000001");
+    assert_false(format_fpu64_trimmed(temp, 8, 100ull, 8));
+    assert_true(format_fpu64_trimmed(temp, 9, 0ull, 18));
+    assert_string_equal(temp, "0");
+    assert_true(format_fpu64_trimmed(temp, 2, 0ull, 18));
+    assert_string_equal(temp, "0");
+    assert_false(format_fpu64_trimmed(temp, 1, 0ull, 18));
+}
+
+static void test_format_fpu64_grouped(void **state)
+{
+    (void) state;
+
+    char temp[40] = {0};
+
+    uint64_t amount = 123456789012ull;
+    assert_true(format_fpu64_grouped(temp, sizeof(temp), amount, 2, ',', false));
+    assert_string_equal(temp, "1,234,567,890.12");
+
+    amount = 1500000000000000000ull;  // wei
+    assert_true(format_fpu64_grouped(temp, sizeof(temp), amount, 18, ' ', true));
+    assert_string_equal(temp, "1.5");
+    assert_true(format_fpu64_grouped(temp, sizeof(temp), amount, 18, ' ', false));
+    assert_string_equal(temp, "1.500000000000000000");
+    assert_true(format_fpu64_grouped(temp, sizeof(temp), amount, 12, '\'', true));
+    assert_string_equal(temp, "1'500'000");
+
+    amount = 18446744073709551615ull;  // MAX_UINT64
+    assert_true(format_fpu64_grouped(temp, sizeof(temp), amount, 0, ',', false));
+    assert_string_equal(temp, "18,446,744,073,709,551,615");
+    // exact size
+    assert_false(format_fpu64_grouped(temp, 26, amount, 0, ',', false));
+    assert_true(format_fpu64_grouped(temp, 27, amount, 0, ',', false));
+
+    // more decimals than digits
+    assert_true(format_fpu64_grouped(temp, sizeof(temp), 42, 22, '\0', false));
+    assert_string_equal(temp, "0.0000000000000000000042");
+    assert_true(format_fpu64_grouped(temp, sizeof(temp), 0, 4, ',', true));
+    assert_string_equal(temp, "0");
 }
 
 static void test_format_hex(void **state)
@@ -132,6 +196,8 @@ int main()
                                        cmocka_unit_test(test_format_u64),
                                        cmocka_unit_test(test_format_fpu64),
                                        cmocka_unit_test(test_format_fpu64_trimmed),
+                                       cmocka_unit_test(test_format_fpu64_small_buffer),
+                                       cmocka_unit_test(test_format_fpu64_grouped),
                                        cmocka_unit_test(test_format_hex)};
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -12,11 +12,13 @@
 
 // Buffer to accumulate outputs
 static char   output_buffer[1024];
-static size_t output_pos = 0;
+static size_t output_pos   = 0;
+static size_t output_calls = 0;
 
 // Mock implementation of os_io_seph_cmd_printf to capture output
 void os_io_seph_cmd_printf(const char *data, size_t len)
 {
+    output_calls++;
     // Accumulate the data in the buffer
     if (output_pos + len < sizeof(output_buffer)) {
         memcpy(output_buffer + output_pos, data, len);
@@ -30,7 +32,8 @@ static int setup(void **state)
 {
     UNUSED(state);
     memset(output_buffer, 0, sizeof(output_buffer));
-    output_pos = 0;
+    output_pos   = 0;
+    output_calls = 0;
     return 0;
 }
 
@@ -110,6 +113,34 @@ static void test_printf_short_padding(void **state)
     assert_string_equal(output_buffer, "Padding: '123454661'");
 }
 
+// Test that the fragments of a printf are sent at once
+static void test_printf_coalesced(void **state)
+{
+    UNUSED(state);
+
+    mcu_usb_printf("%s=%d, %s=0x%x%c\n", "first", 12, "second", 0xAB, '!');
+    assert_string_equal(output_buffer, "first=12, second=0xab!\n");
+    assert_int_equal(output_calls, 1);
+
+    // nothing sent for an empty string
+    mcu_usb_printf("");
+    assert_int_equal(output_calls, 1);
+}
+
+// Test printf longer than the coalescing buffer
+static void test_printf_long_output(void **state)
+{
+    UNUSED(state);
+    char expected[400];
+
+    memset(expected, 'x', 300);
+    memcpy(&expected[300], "42", 3);
+    mcu_usb_printf("%.*s%d", 300, expected, 42);
+    assert_string_equal(output_buffer, expected);
+    // 128-byte buffer
+    assert_int_equal(output_calls, 3);
+}
+
 // ****************************************************************************
 // Unit Tests for snprintf
 // ****************************************************************************
@@ -579,6 +610,8 @@ int main(int argc, char **argv)
            cmocka_unit_test_setup(test_printf_long_padding, setup),
            cmocka_unit_test_setup(test_printf_short_padding, setup),
            cmocka_unit_test_setup(test_printf_d_padded, setup),
+           cmocka_unit_test_setup(test_printf_coalesced, setup),
+           cmocka_unit_test_setup(test_printf_long_output, setup),
            // snprintf tests
            cmocka_unit_test_setup(test_snprintf_lld, setup),
            cmocka_unit_test_setup(test_snprintf_llX_padded, setup),
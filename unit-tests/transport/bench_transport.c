@@ -0,0 +1,787 @@
+/**
+ * Host loopback benchmark of the APDU framing layers.
+ *
+ * Synthetic APDUs are sent by a host model through a simulated link (see sim_link.h) to the
+ * device-side framing code of the SDK (Ledger protocol, U2F/CTAPHID transport, CCID transport
+ * and command layer), which reassembles them. The device answers with a synthetic response,
+ * fragmented by the same framing code, and reassembled by the host model.
+ *
+ * Each exchange is checked byte per byte, so the benchmark also acts as a regression test:
+ * the exit code is not 0 if any APDU is corrupted or cannot be exchanged.
+ *
+ * Reported figures:
+ * - chunks sent in each direction, lost chunks and retries,
+ * - goodput on the simulated link (APDU bytes per simulated second),
+ * - per-APDU latency on the simulated link (min/avg/max, retries included),
+ * - CPU throughput of the device-side framing code (APDU bytes per wall-clock second).
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "os.h"
+#include "ledger_protocol.h"
+#include "u2f_types.h"
+#include "u2f_transport.h"
+#include "ccid_types.h"
+#include "ccid_transport.h"
+#include "ccid_cmd.h"
+#include "sim_link.h"
+
+/* Private defines------------------------------------------------------------*/
+#define BENCH_MAX_APDU_SIZE        4096
+// framing layers store the packet length on 8 bits
+#define BENCH_MAX_MTU              255
+#define BENCH_MAX_RETRIES          16
+#define BENCH_CHANNEL_ID           0x0101
+#define BENCH_U2F_CID              0x01020304
+#define BENCH_U2F_OTHER_CID        0x05060708
+#define BENCH_U2F_GONE_CID         0x090A0B0C
+#define BENCH_U2F_LARGE_CID        0x0D0E0F10
+// data of a request which fits a pending channel of the U2F transport
+#define BENCH_U2F_PENDING_MAX_DATA (U2F_TRANSPORT_PENDING_MESSAGE_SIZE - 3)
+#define BENCH_TAG_APDU             0x05
+// CCID XfrBlock is limited to short APDUs
+#define BENCH_CCID_MAX_APDU        261
+#define BENCH_CCID_HEADER_LEN      10
+
+/* Private types, structures, unions -----------------------------------------*/
+typedef enum {
+    BENCH_EXCHANGE_OK,
+    BENCH_EXCHANGE_LOST,       ///< a chunk was lost, the host has to retry
+    BENCH_EXCHANGE_CORRUPTED,  ///< data were received but differ from what was sent
+} bench_exchange_t;
+
+typedef struct bench_stats_s {
+    uint32_t nb_apdus;
+    uint32_t nb_failed;
+    uint32_t nb_corrupted;
+    uint32_t nb_retries;
+    uint32_t chunks_out;  ///< host to device chunks
+    uint32_t chunks_in;   ///< device to host chunks
+    uint64_t apdu_bytes;  ///< command + response bytes successfully exchanged
+    uint64_t latency_min_us;
+    uint64_t latency_max_us;
+    uint64_t latency_sum_us;
+    uint64_t framing_ns;  ///< wall-clock time spent in the device-side framing code
+} bench_stats_t;
+
+typedef struct bench_transport_s {
+    const char *name;
+    uint16_t    min_mtu;
+    uint16_t    max_command_size;
+    void (*reset)(void);
+    bench_exchange_t (*exchange)(sim_link_t    *link,
+                                 const uint8_t *command,
+                                 uint16_t       command_length,
+                                 const uint8_t *response,
+                                 uint16_t       response_length,
+                                 bench_stats_t *stats);
+} bench_transport_t;
+
+typedef struct bench_config_s {
+    sim_link_config_t link;
+    const char       *transport;
+    uint32_t          nb_apdus;
+    uint16_t          command_length;
+    uint16_t          response_length;
+    uint32_t          timeout_us;
+} bench_config_t;
+
+/* Private macros-------------------------------------------------------------*/
+// Accounts the wall-clock time of a call to the SDK framing code
+#define BENCH_TIMED(stats, call)                       \
+    do {                                               \
+        uint64_t _start = bench_now_ns();              \
+        call;                                          \
+        (stats)->framing_ns += bench_now_ns() - _start; \
+    } while (0)
+
+/* Private variables ---------------------------------------------------------*/
+static uint16_t bench_mtu;
+static uint8_t  host_packet[BENCH_MAX_MTU];
+static uint8_t  host_message[BENCH_MAX_APDU_SIZE + BENCH_CCID_HEADER_LEN];
+static uint8_t  host_response[BENCH_MAX_APDU_SIZE];
+
+static ledger_protocol_t hid_protocol;
+static uint8_t           hid_chunk[BENCH_MAX_MTU];
+static uint8_t           hid_apdu[BENCH_MAX_APDU_SIZE + 1];
+
+static u2f_transport_t u2f_transport;
+static uint8_t         u2f_packet[BENCH_MAX_MTU];
+static uint8_t         u2f_message[BENCH_MAX_APDU_SIZE + 3];
+
+static ccid_device_t ccid_device;
+static uint8_t       ccid_packet[BENCH_MAX_MTU];
+static uint8_t       ccid_message[BENCH_MAX_APDU_SIZE + BENCH_CCID_HEADER_LEN + 1];
+static uint8_t       ccid_seq;
+
+/* Private functions ---------------------------------------------------------*/
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+static void bench_fill(uint8_t *buffer, uint16_t length, uint32_t seed)
+{
+    for (uint16_t i = 0; i < length; i++) {
+        seed      = seed * 1103515245 + 12345;
+        buffer[i] = seed >> 16;
+    }
+}
+
+// Ledger protocol over USB HID ------------------------------------------------
+static void hid_reset(void)
+{
+    memset(&hid_protocol, 0, sizeof(hid_protocol));
+    LEDGER_PROTOCOL_init(&hid_protocol, 0);
+}
+
+static bench_exchange_t hid_exchange(sim_link_t    *link,
+                                     const uint8_t *command,
+                                     uint16_t       command_length,
+                                     const uint8_t *response,
+                                     uint16_t       response_length,
+                                     bench_stats_t *stats)
+{
+    uint16_t offset = 0;
+    uint16_t seq    = 0;
+    bool     lost   = false;
+
+    // Host to device
+    do {
+        uint16_t header_length = 5;
+        memset(host_packet, 0, bench_mtu);
+        U2BE_ENCODE(host_packet, 0, BENCH_CHANNEL_ID);
+        host_packet[2] = BENCH_TAG_APDU;
+        U2BE_ENCODE(host_packet, 3, seq);
+        if (seq == 0) {
+            U2BE_ENCODE(host_packet, 5, command_length);
+            header_length += 2;
+        }
+        uint16_t length = MIN(bench_mtu - header_length, command_length - offset);
+        memcpy(&host_packet[header_length], &command[offset], length);
+        offset += length;
+        seq++;
+
+        stats->chunks_out++;
+        // once a chunk is lost, the device does not get the rest of the command
+        if (!sim_link_transfer(link, bench_mtu)) {
+            lost = true;
+        }
+        else if (!lost) {
+            BENCH_TIMED(stats,
+                        LEDGER_PROTOCOL_rx(&hid_protocol,
+                                           host_packet,
+                                           bench_mtu,
+                                           hid_chunk,
+                                           bench_mtu,
+                                           hid_apdu,
+                                           sizeof(hid_apdu),
+                                           bench_mtu));
+        }
+    } while (offset < command_length);
+
+    if (lost || (hid_protocol.rx_apdu_status != APDU_STATUS_COMPLETE)) {
+        return BENCH_EXCHANGE_LOST;
+    }
+    hid_protocol.rx_apdu_status = APDU_STATUS_WAITING;
+    if ((hid_protocol.rx_apdu_length != command_length + 1)
+        || memcmp(&hid_apdu[1], command, command_length)) {
+        return BENCH_EXCHANGE_CORRUPTED;
+    }
+
+    // Device to host
+    uint16_t expected_seq = 0;
+    uint16_t total_length = 0;
+    offset                = 0;
+    BENCH_TIMED(stats,
+                LEDGER_PROTOCOL_tx(
+                    &hid_protocol, response, response_length, hid_chunk, bench_mtu, bench_mtu));
+    while (true) {
+        stats->chunks_in++;
+        if (!sim_link_transfer(link, bench_mtu)) {
+            lost = true;
+        }
+        else if (!lost) {
+            uint16_t header_length = 5;
+            if ((hid_chunk[2] != BENCH_TAG_APDU) || (U2BE(hid_chunk, 3) != expected_seq)) {
+                return BENCH_EXCHANGE_CORRUPTED;
+            }
+            if (expected_seq == 0) {
+                total_length = U2BE(hid_chunk, 5);
+                header_length += 2;
+            }
+            uint16_t length = MIN(bench_mtu - header_length, total_length - offset);
+            memcpy(&host_response[offset], &hid_chunk[header_length], length);
+            offset += length;
+            expected_seq++;
+        }
+        if (!hid_protocol.tx_apdu_buffer) {
+            break;
+        }
+        BENCH_TIMED(stats,
+                    LEDGER_PROTOCOL_tx(&hid_protocol, NULL, 0, hid_chunk, bench_mtu, bench_mtu));
+    }
+    if (lost) {
+        return BENCH_EXCHANGE_LOST;
+    }
+    if ((total_length != response_length) || (offset != response_length)
+        || memcmp(host_response, response, response_length)) {
+        return BENCH_EXCHANGE_CORRUPTED;
+    }
+    return BENCH_EXCHANGE_OK;
+}
+
+// U2F / CTAPHID over USB HID --------------------------------------------------
+static void u2f_reset(void)
+{
+    memset(&u2f_transport, 0, sizeof(u2f_transport));
+    U2F_TRANSPORT_init(&u2f_transport, U2F_TRANSPORT_TYPE_USB_HID);
+    u2f_transport.rx_message_buffer      = u2f_message;
+    u2f_transport.rx_message_buffer_size = sizeof(u2f_message);
+}
+
+// Sends a CTAPHID message on a channel, returns false if a chunk was lost
+static bool u2f_send(sim_link_t    *link,
+                     uint32_t       cid,
+                     const uint8_t *command,
+                     uint16_t       command_length,
+                     bench_stats_t *stats)
+{
+    uint16_t offset = 0;
+    uint8_t  seq    = 0;
+    bool     lost   = false;
+
+    do {
+        uint16_t header_length = 5;
+        memset(host_packet, 0, bench_mtu);
+        U4BE_ENCODE(host_packet, 0, cid);
+        if (offset == 0) {
+            host_packet[4] = U2F_COMMAND_MSG | 0x80;
+            U2BE_ENCODE(host_packet, 5, command_length);
+            header_length += 2;
+        }
+        else {
+            host_packet[4] = seq++;
+        }
+        uint16_t length = MIN(bench_mtu - header_length, command_length - offset);
+        memcpy(&host_packet[header_length], &command[offset], length);
+        offset += length;
+
+        stats->chunks_out++;
+        // once a chunk is lost, the device does not get the rest of the command
+        if (!sim_link_transfer(link, bench_mtu)) {
+            lost = true;
+        }
+        else if (!lost) {
+            BENCH_TIMED(stats, U2F_TRANSPORT_rx(&u2f_transport, host_packet, bench_mtu));
+        }
+    } while (offset < command_length);
+
+    return !lost;
+}
+
+// Checks the request dispatched by the transport for a channel
+static bench_exchange_t u2f_check_request(uint32_t       cid,
+                                          const uint8_t *command,
+                                          uint16_t       command_length)
+{
+    if ((u2f_transport.error != CTAP1_ERR_SUCCESS)
+        || (u2f_transport.state != U2F_STATE_CMD_COMPLETE)) {
+        return BENCH_EXCHANGE_LOST;
+    }
+    u2f_transport.state = U2F_STATE_CMD_PROCESSING;
+    if ((u2f_transport.cid != cid) || (u2f_transport.tx_cid != cid)
+        || (u2f_transport.rx_message_length != command_length + 3)
+        || (u2f_message[0] != U2F_COMMAND_MSG) || memcmp(&u2f_message[3], command, command_length)) {
+        return BENCH_EXCHANGE_CORRUPTED;
+    }
+    return BENCH_EXCHANGE_OK;
+}
+
+// Sends the device response on the channel in use, and reassembles it on host side
+static bench_exchange_t u2f_receive(sim_link_t    *link,
+                                    uint32_t       cid,
+                                    const uint8_t *response,
+                                    uint16_t       response_length,
+                                    bench_stats_t *stats)
+{
+    uint8_t  expected_seq = 0;
+    uint16_t total_length = 0;
+    uint16_t offset       = 0;
+    bool     first        = true;
+    bool     lost         = false;
+
+    BENCH_TIMED(stats,
+                U2F_TRANSPORT_tx(&u2f_transport,
+                                 U2F_COMMAND_MSG,
+                                 response,
+                                 response_length,
+                                 u2f_packet,
+                                 bench_mtu));
+    while (true) {
+        stats->chunks_in++;
+        if (!sim_link_transfer(link, bench_mtu)) {
+            lost = true;
+        }
+        else if (!lost) {
+            uint16_t header_length = 5;
+            if (U4BE(u2f_packet, 0) != cid) {
+                return BENCH_EXCHANGE_CORRUPTED;
+            }
+            if (first) {
+                if (u2f_packet[4] != (U2F_COMMAND_MSG | 0x80)) {
+                    return BENCH_EXCHANGE_CORRUPTED;
+                }
+                total_length = U2BE(u2f_packet, 5);
+                header_length += 2;
+                first = false;
+            }
+            else if (u2f_packet[4] != expected_seq++) {
+                return BENCH_EXCHANGE_CORRUPTED;
+            }
+            uint16_t length = MIN(bench_mtu - header_length, total_length - offset);
+            memcpy(&host_response[offset], &u2f_packet[header_length], length);
+            offset += length;
+        }
+        if (!u2f_transport.tx_message_buffer) {
+            break;
+        }
+        BENCH_TIMED(stats, U2F_TRANSPORT_tx(&u2f_transport, 0, NULL, 0, u2f_packet, bench_mtu));
+    }
+    // as the USB class does once the last packet has been sent
+    if (u2f_transport.state == U2F_STATE_CMD_PROCESSING) {
+        u2f_transport.state = U2F_STATE_IDLE;
+    }
+    if (lost) {
+        return BENCH_EXCHANGE_LOST;
+    }
+    if ((total_length != response_length) || (offset != response_length)
+        || memcmp(host_response, response, response_length)) {
+        return BENCH_EXCHANGE_CORRUPTED;
+    }
+    return BENCH_EXCHANGE_OK;
+}
+
+static bench_exchange_t u2f_exchange(sim_link_t    *link,
+                                     const uint8_t *command,
+                                     uint16_t       command_length,
+                                     const uint8_t *response,
+                                     uint16_t       response_length,
+                                     bench_stats_t *stats)
+{
+    bench_exchange_t result = BENCH_EXCHANGE_LOST;
+
+    if (!u2f_send(link, BENCH_U2F_CID, command, command_length, stats)) {
+        return BENCH_EXCHANGE_LOST;
+    }
+    result = u2f_check_request(BENCH_U2F_CID, command, command_length);
+    if (result != BENCH_EXCHANGE_OK) {
+        return result;
+    }
+    return u2f_receive(link, BENCH_U2F_CID, response, response_length, stats);
+}
+
+// Two CTAPHID clients: while the request of the first one is processed, the second one sends a
+// short request on its own channel. It has to be buffered by the transport, and dispatched as
+// soon as the response of the first one has been sent.
+static bench_exchange_t u2f_channels_exchange(sim_link_t    *link,
+                                              const uint8_t *command,
+                                              uint16_t       command_length,
+                                              const uint8_t *response,
+                                              uint16_t       response_length,
+                                              bench_stats_t *stats)
+{
+    bench_exchange_t result       = BENCH_EXCHANGE_LOST;
+    uint16_t         short_length = MIN(command_length, BENCH_U2F_PENDING_MAX_DATA);
+    uint8_t          error        = CTAP1_ERR_SUCCESS;
+
+    if (!u2f_send(link, BENCH_U2F_CID, command, command_length, stats)) {
+        return BENCH_EXCHANGE_LOST;
+    }
+    result = u2f_check_request(BENCH_U2F_CID, command, command_length);
+    if (result != BENCH_EXCHANGE_OK) {
+        return result;
+    }
+
+    if (!u2f_send(link, BENCH_U2F_OTHER_CID, response, short_length, stats)) {
+        return BENCH_EXCHANGE_LOST;
+    }
+    if ((u2f_transport.error != CTAP1_ERR_SUCCESS) || (u2f_transport.cid != BENCH_U2F_CID)
+        || (u2f_transport.state != U2F_STATE_CMD_PROCESSING)) {
+        // the other channel must not disturb the one in use
+        return BENCH_EXCHANGE_CORRUPTED;
+    }
+
+    // A third client only sends the initialization packet of its request and is gone: its
+    // channel has to be freed by the transaction timeout
+    memset(host_packet, 0, bench_mtu);
+    U4BE_ENCODE(host_packet, 0, BENCH_U2F_GONE_CID);
+    host_packet[4] = U2F_COMMAND_MSG | 0x80;
+    U2BE_ENCODE(host_packet, 5, BENCH_U2F_PENDING_MAX_DATA);
+    BENCH_TIMED(stats, U2F_TRANSPORT_rx(&u2f_transport, host_packet, 7));
+    BENCH_TIMED(stats,
+                U2F_TRANSPORT_ticker(&u2f_transport, U2F_TRANSPORT_TRANSACTION_TIMEOUT_MS));
+    for (uint8_t index = 0; index < U2F_TRANSPORT_MAX_PENDING_CHANNELS; index++) {
+        const u2f_transport_channel_t *channel = &u2f_transport.pending_channels[index];
+        if ((channel->state != U2F_STATE_IDLE) && (channel->cid == BENCH_U2F_GONE_CID)) {
+            return BENCH_EXCHANGE_CORRUPTED;
+        }
+    }
+
+    // A request too large for a pending channel is rejected at once with CTAP1_ERR_CHANNEL_BUSY,
+    // without taking a slot, and the error is sent on its channel
+    memset(host_packet, 0, bench_mtu);
+    U4BE_ENCODE(host_packet, 0, BENCH_U2F_LARGE_CID);
+    host_packet[4] = U2F_COMMAND_MSG | 0x80;
+    U2BE_ENCODE(host_packet, 5, BENCH_U2F_PENDING_MAX_DATA + 1);
+    BENCH_TIMED(stats, U2F_TRANSPORT_rx(&u2f_transport, host_packet, 7));
+    if ((u2f_transport.error != CTAP1_ERR_CHANNEL_BUSY)
+        || (u2f_transport.tx_cid != BENCH_U2F_LARGE_CID)) {
+        return BENCH_EXCHANGE_CORRUPTED;
+    }
+    for (uint8_t index = 0; index < U2F_TRANSPORT_MAX_PENDING_CHANNELS; index++) {
+        const u2f_transport_channel_t *channel = &u2f_transport.pending_channels[index];
+        if ((channel->state != U2F_STATE_IDLE) && (channel->cid == BENCH_U2F_LARGE_CID)) {
+            return BENCH_EXCHANGE_CORRUPTED;
+        }
+    }
+    // as the USB class does with a transport error
+    error               = u2f_transport.error;
+    u2f_transport.error = CTAP1_ERR_SUCCESS;
+    BENCH_TIMED(stats,
+                U2F_TRANSPORT_tx(
+                    &u2f_transport, U2F_COMMAND_ERROR, &error, 1, u2f_packet, bench_mtu));
+    if ((U4BE(u2f_packet, 0) != BENCH_U2F_LARGE_CID) || (u2f_transport.cid != BENCH_U2F_CID)
+        || (u2f_transport.tx_cid != BENCH_U2F_CID)) {
+        return BENCH_EXCHANGE_CORRUPTED;
+    }
+
+    result = u2f_receive(link, BENCH_U2F_CID, response, response_length, stats);
+    if (result != BENCH_EXCHANGE_OK) {
+        return result;
+    }
+
+    result = u2f_check_request(BENCH_U2F_OTHER_CID, response, short_length);
+    if (result != BENCH_EXCHANGE_OK) {
+        return result;
+    }
+    return u2f_receive(link, BENCH_U2F_OTHER_CID, command, short_length, stats);
+}
+
+// CCID over USB bulk endpoints ------------------------------------------------
+static void ccid_reset(void)
+{
+    memset(&ccid_device, 0, sizeof(ccid_device));
+    CCID_TRANSPORT_init(&ccid_device.transport);
+    ccid_device.transport.rx_msg_buffer      = ccid_message;
+    ccid_device.transport.rx_msg_buffer_size = sizeof(ccid_message);
+    ccid_device.card_inserted                = 1;
+}
+
+static bench_exchange_t ccid_exchange(sim_link_t    *link,
+                                      const uint8_t *command,
+                                      uint16_t       command_length,
+                                      const uint8_t *response,
+                                      uint16_t       response_length,
+                                      bench_stats_t *stats)
+{
+    uint16_t message_length = BENCH_CCID_HEADER_LEN + command_length;
+    uint16_t offset         = 0;
+    int32_t  status         = 0;
+    bool     lost           = false;
+
+    // PC_to_RDR_XfrBlock message
+    memset(host_message, 0, BENCH_CCID_HEADER_LEN);
+    host_message[0] = CCID_COMMAND_PC_TO_RDR_XFR_BLOCK;
+    U4LE_ENCODE(host_message, 1, command_length);
+    host_message[6] = ++ccid_seq;
+    memcpy(&host_message[BENCH_CCID_HEADER_LEN], command, command_length);
+
+    // Host to device, the last bulk packet may be short
+    do {
+        uint16_t length = MIN(bench_mtu, message_length - offset);
+        memcpy(host_packet, &host_message[offset], length);
+        offset += length;
+
+        stats->chunks_out++;
+        // once a chunk is lost, the device does not get the rest of the command
+        if (!sim_link_transfer(link, length)) {
+            lost = true;
+        }
+        else if (!lost) {
+            BENCH_TIMED(stats, CCID_TRANSPORT_rx(&ccid_device.transport, host_packet, length));
+        }
+    } while (offset < message_length);
+
+    if (lost || (ccid_device.transport.rx_msg_status != CCID_MSG_STATUS_COMPLETE)) {
+        return BENCH_EXCHANGE_LOST;
+    }
+    BENCH_TIMED(stats, status = CCID_CMD_process(&ccid_device));
+    ccid_device.transport.rx_msg_status = CCID_MSG_STATUS_WAITING;
+    if ((status != 1) || (ccid_device.transport.rx_msg_length != command_length)
+        || memcmp(ccid_message, command, command_length)) {
+        return BENCH_EXCHANGE_CORRUPTED;
+    }
+
+    // Device to host, RDR_to_PC_DataBlock message
+    uint16_t total_length = 0;
+    bool     first        = true;
+    offset                = 0;
+    BENCH_TIMED(stats,
+                CCID_TRANSPORT_tx(
+                    &ccid_device.transport, response, response_length, ccid_packet, bench_mtu));
+    while (true) {
+        const uint8_t *packet        = ccid_device.transport.tx_packet;
+        uint8_t        packet_length = ccid_device.transport.tx_packet_length;
+        uint16_t       header_length = 0;
+        stats->chunks_in++;
+        if (!sim_link_transfer(link, packet_length)) {
+            lost = true;
+        }
+        else if (!lost) {
+            if (first) {
+                if ((packet[0] != CCID_COMMAND_RDR_TO_PC_DATA_BLOCK) || (packet[6] != ccid_seq)) {
+                    return BENCH_EXCHANGE_CORRUPTED;
+                }
+                total_length  = U4LE(packet, 1);
+                header_length = BENCH_CCID_HEADER_LEN;
+                first         = false;
+            }
+            uint16_t length = MIN(packet_length - header_length, total_length - offset);
+            memcpy(&host_response[offset], &packet[header_length], length);
+            offset += length;
+        }
+        if (!ccid_device.transport.tx_message_buffer) {
+            break;
+        }
+        BENCH_TIMED(
+            stats,
+            CCID_TRANSPORT_tx(&ccid_device.transport, NULL, 0, ccid_packet, bench_mtu));
+    }
+    if (lost) {
+        return BENCH_EXCHANGE_LOST;
+    }
+    if ((total_length != response_length) || (offset != response_length)
+        || memcmp(host_response, response, response_length)) {
+        return BENCH_EXCHANGE_CORRUPTED;
+    }
+    return BENCH_EXCHANGE_OK;
+}
+
+static const bench_transport_t bench_transports[] = {
+    {"hid",   8,                         BENCH_MAX_APDU_SIZE, hid_reset,  hid_exchange         },
+    {"u2f",   8,                         BENCH_MAX_APDU_SIZE, u2f_reset,  u2f_exchange         },
+    {"u2fmc", 8,                         BENCH_MAX_APDU_SIZE, u2f_reset,  u2f_channels_exchange},
+    {"ccid",  BENCH_CCID_HEADER_LEN + 1, BENCH_CCID_MAX_APDU, ccid_reset, ccid_exchange        },
+};
+
+static int bench_run(const bench_transport_t *transport, const bench_config_t *config)
+{
+    static uint8_t command[BENCH_MAX_APDU_SIZE];
+    static uint8_t response[BENCH_MAX_APDU_SIZE];
+    bench_stats_t  stats = {0};
+    sim_link_t     link;
+    uint16_t       command_length = MIN(config->command_length, transport->max_command_size);
+
+    if (bench_mtu < transport->min_mtu) {
+        fprintf(stderr, "%s: MTU must be at least %u\n", transport->name, transport->min_mtu);
+        return 1;
+    }
+
+    sim_link_init(&link, &config->link);
+    transport->reset();
+    stats.latency_min_us = UINT64_MAX;
+
+    for (uint32_t i = 0; i < config->nb_apdus; i++) {
+        bench_exchange_t result = BENCH_EXCHANGE_LOST;
+        uint64_t         start  = link.now_us;
+
+        bench_fill(command, command_length, 2 * i);
+        bench_fill(response, config->response_length, 2 * i + 1);
+        for (uint32_t attempt = 0; attempt <= BENCH_MAX_RETRIES; attempt++) {
+            result = transport->exchange(
+                &link, command, command_length, response, config->response_length, &stats);
+            if (result != BENCH_EXCHANGE_LOST) {
+                break;
+            }
+            // the host gives up after its timeout, and the transport is reset before retrying
+            stats.nb_retries++;
+            sim_link_wait(&link, config->timeout_us);
+            transport->reset();
+        }
+
+        stats.nb_apdus++;
+        if (result == BENCH_EXCHANGE_CORRUPTED) {
+            stats.nb_corrupted++;
+            transport->reset();
+            continue;
+        }
+        if (result != BENCH_EXCHANGE_OK) {
+            stats.nb_failed++;
+            continue;
+        }
+        uint64_t latency = link.now_us - start;
+        stats.apdu_bytes += command_length + config->response_length;
+        stats.latency_sum_us += latency;
+        stats.latency_min_us = MIN(stats.latency_min_us, latency);
+        stats.latency_max_us = MAX(stats.latency_max_us, latency);
+    }
+
+    uint32_t nb_ok = stats.nb_apdus - stats.nb_failed - stats.nb_corrupted;
+    printf("%-5s %7u %5u %5u %9u %9u %7u %7u %12.0f %9.0f %9.0f %9.0f %10.2f %s\n",
+           transport->name,
+           stats.nb_apdus,
+           command_length,
+           config->response_length,
+           stats.chunks_out,
+           stats.chunks_in,
+           link.nb_lost,
+           stats.nb_retries,
+           link.now_us ? (double) stats.apdu_bytes * 1000000.0 / link.now_us : 0.0,
+           nb_ok ? (double) stats.latency_min_us : 0.0,
+           nb_ok ? (double) stats.latency_sum_us / nb_ok : 0.0,
+           (double) stats.latency_max_us,
+           stats.framing_ns ? (double) stats.apdu_bytes * 1000.0 / stats.framing_ns : 0.0,
+           (stats.nb_failed || stats.nb_corrupted) ? "FAILED" : "OK");
+    if (stats.nb_corrupted) {
+        fprintf(stderr, "%s: %u corrupted APDU(s)\n", transport->name, stats.nb_corrupted);
+    }
+    if (stats.nb_failed) {
+        fprintf(stderr,
+                "%s: %u APDU(s) not exchanged after %u retries\n",
+                transport->name,
+                stats.nb_failed,
+                BENCH_MAX_RETRIES);
+    }
+
+    return (stats.nb_failed || stats.nb_corrupted) ? 1 : 0;
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  --transport <name|all>          framing layer to benchmark (default: all):\n");
+    printf("                                  hid, u2f, u2fmc (two U2F channels), ccid\n");
+    printf("  --apdus <n>                     number of exchanged APDUs (default: 1000)\n");
+    printf("  --size <n>                      command length, in bytes (default: 255)\n");
+    printf("  --response <n>                  response length, in bytes (default: 256)\n");
+    printf("  --mtu <n>                       link packet size, in bytes (default: 64)\n");
+    printf("  --latency-us <n>                per-packet latency (default: 1000)\n");
+    printf("  --bandwidth <n>                 bytes per second, 0 is unlimited (default: 0)\n");
+    printf("  --loss-ppm <n>                  packet loss, in parts per million (default: 0)\n");
+    printf("  --timeout-us <n>                host timeout before a retry (default: 100000)\n");
+    printf("  --seed <n>                      seed of the loss generator (default: 1)\n");
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+    static const struct option options[] = {
+        {"transport",  required_argument, NULL, 't'},
+        {"apdus",      required_argument, NULL, 'n'},
+        {"size",       required_argument, NULL, 's'},
+        {"response",   required_argument, NULL, 'r'},
+        {"mtu",        required_argument, NULL, 'm'},
+        {"latency-us", required_argument, NULL, 'l'},
+        {"bandwidth",  required_argument, NULL, 'b'},
+        {"loss-ppm",   required_argument, NULL, 'p'},
+        {"timeout-us", required_argument, NULL, 'o'},
+        {"seed",       required_argument, NULL, 'e'},
+        {"help",       no_argument,       NULL, 'h'},
+        {NULL,         0,                 NULL, 0  },
+    };
+    bench_config_t config = {
+        .link            = {.mtu = 64, .latency_us = 1000, .bandwidth = 0, .loss_ppm = 0, .seed = 1},
+        .transport       = "all",
+        .nb_apdus        = 1000,
+        .command_length  = 255,
+        .response_length = 256,
+        .timeout_us      = 100000,
+    };
+    int opt;
+    int status = 0;
+
+    while ((opt = getopt_long(argc, argv, "h", options, NULL)) != -1) {
+        switch (opt) {
+            case 't':
+                config.transport = optarg;
+                break;
+            case 'n':
+                config.nb_apdus = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                config.command_length = MIN(strtoul(optarg, NULL, 0), BENCH_MAX_APDU_SIZE);
+                break;
+            case 'r':
+                config.response_length = MIN(strtoul(optarg, NULL, 0), BENCH_MAX_APDU_SIZE);
+                break;
+            case 'm':
+                config.link.mtu = MIN(strtoul(optarg, NULL, 0), BENCH_MAX_MTU);
+                break;
+            case 'l':
+                config.link.latency_us = strtoul(optarg, NULL, 0);
+                break;
+            case 'b':
+                config.link.bandwidth = strtoul(optarg, NULL, 0);
+                break;
+            case 'p':
+                config.link.loss_ppm = strtoul(optarg, NULL, 0);
+                break;
+            case 'o':
+                config.timeout_us = strtoul(optarg, NULL, 0);
+                break;
+            case 'e':
+                config.link.seed = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+    bench_mtu = config.link.mtu;
+
+    printf("MTU %u bytes, latency %u us, bandwidth %u B/s, loss %u ppm\n",
+           config.link.mtu,
+           config.link.latency_us,
+           config.link.bandwidth,
+           config.link.loss_ppm);
+    printf("%-5s %7s %5s %5s %9s %9s %7s %7s %12s %9s %9s %9s %10s\n",
+           "proto",
+           "apdus",
+           "cmd",
+           "rsp",
+           "chunk_out",
+           "chunk_in",
+           "lost",
+           "retries",
+           "goodput_B/s",
+           "lat_min",
+           "lat_avg",
+           "lat_max",
+           "cpu_MB/s");
+
+    bool found = false;
+    for (size_t i = 0; i < sizeof(bench_transports) / sizeof(bench_transports[0]); i++) {
+        if (strcmp(config.transport, "all") && strcmp(config.transport, bench_transports[i].name)) {
+            continue;
+        }
+        found = true;
+        status |= bench_run(&bench_transports[i], &config);
+    }
+    if (!found) {
+        fprintf(stderr, "Unknown transport '%s'\n", config.transport);
+        return 1;
+    }
+
+    return status;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// Host replacement for the SDK os.h: the framing layers only need the basic helpers,
+// not the whole OS API (which drags the UX, crypto and syscall headers).
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "os_helpers.h"
+#include "os_math.h"
+#include "os_utils.h"
@@ -0,0 +1,4 @@
+#pragma once
+
+// Host replacement for the SDK os_io.h: nothing from the IO stack is needed by the framing layers.
+#include <stdint.h>
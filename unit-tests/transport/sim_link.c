@@ -0,0 +1,66 @@
+/**
+ * Simulated link used to drive the framing layers on host.
+ *
+ * The link has no real wire: it only accounts for the time each packet would take
+ * (fixed latency + serialization time) on a simulated clock, and decides, in a
+ * deterministic way, whether the packet is lost.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+
+#include "sim_link.h"
+
+/* Private functions ---------------------------------------------------------*/
+// xorshift32, enough to get a reproducible loss pattern
+static uint32_t sim_link_rand(sim_link_t *link)
+{
+    uint32_t x = link->rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    link->rng_state = x;
+    return x;
+}
+
+/* Exported functions --------------------------------------------------------*/
+void sim_link_init(sim_link_t *link, const sim_link_config_t *config)
+{
+    memset(link, 0, sizeof(*link));
+    link->config    = *config;
+    link->rng_state = config->seed ? config->seed : 0x2545F491;
+}
+
+/**
+ * @brief Puts a packet on the link
+ *
+ * @param link simulated link
+ * @param length length of the packet, in bytes
+ * @return true if the packet reached the other side, false if it has been lost
+ */
+bool sim_link_transfer(sim_link_t *link, uint16_t length)
+{
+    link->nb_packets++;
+    link->nb_bytes += length;
+    link->now_us += link->config.latency_us;
+    if (link->config.bandwidth) {
+        link->now_us += ((uint64_t) length * 1000000) / link->config.bandwidth;
+    }
+
+    if (link->config.loss_ppm && ((sim_link_rand(link) % 1000000) < link->config.loss_ppm)) {
+        link->nb_lost++;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Lets the simulated time elapse (e.g. host side timeout)
+ *
+ * @param link simulated link
+ * @param duration_us duration, in microseconds
+ */
+void sim_link_wait(sim_link_t *link, uint32_t duration_us)
+{
+    link->now_us += duration_us;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported types, structures, unions ----------------------------------------*/
+typedef struct sim_link_config_s {
+    uint16_t mtu;         ///< size of a link packet, in bytes
+    uint32_t latency_us;  ///< fixed latency of each packet, in microseconds
+    uint32_t bandwidth;   ///< link bandwidth, in bytes per second (0 means unlimited)
+    uint32_t loss_ppm;    ///< probability for a packet to be lost, in parts per million
+    uint32_t seed;        ///< seed of the (deterministic) loss generator
+} sim_link_config_t;
+
+typedef struct sim_link_s {
+    sim_link_config_t config;
+
+    uint32_t rng_state;
+    uint64_t now_us;  ///< simulated clock, in microseconds
+
+    uint32_t nb_packets;  ///< packets put on the link (including lost ones)
+    uint32_t nb_lost;     ///< packets lost by the link
+    uint64_t nb_bytes;    ///< bytes put on the link (including lost ones)
+} sim_link_t;
+
+/* Exported functions prototypes--------------------------------------------- */
+void sim_link_init(sim_link_t *link, const sim_link_config_t *config);
+bool sim_link_transfer(sim_link_t *link, uint16_t length);
+void sim_link_wait(sim_link_t *link, uint32_t duration_us);